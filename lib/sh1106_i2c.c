@@ -5,10 +5,35 @@
 
 #include "sh1106_i2c.h"
 
-uint8_t pageBuffer[8][128];
+#define ROW_HEADER SH1106_ROW_HEADER
+#define FB(sh1106, page, x) (sh1106)->back[page][ROW_HEADER + (x)]
 const uint8_t bytes_per_char = 16 * (9 / 8 + ((9 % 8) ? 1 : 0));
-#define FONT_HEIGHT 16
-#define FONT_WIDTH 8
+// 3 commands (control + command) plus the data control byte and a w-column span
+#define PAGE_COST(w) (ROW_HEADER + (w))
+#define CTRL_CMD_SINGLE 0x80 // Co=1: one command byte follows, then another control byte
+#define CTRL_CMD_STREAM 0x00 // Co=0: every following byte is a command
+#define CTRL_DATA       0x40 // Co=0, D/C=1: every following byte is display data
+#define MERGE_GAP (ROW_HEADER + 1) // setup bytes plus the address byte of a new transaction
+
+#define TIMEOUT_US(len) (SH1106_TIMEOUT_BASE_US + (uint32_t)(len) * SH1106_TIMEOUT_BYTE_US)
+
+static sh1106_t *busOwner[2]; //instance whose DMA frame is driving i2c0 / i2c1
+static void async_step(sh1106_t *sh1106);
+
+// Command-stream builder: packs several commands and one data run into a single transaction
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+} stream_t;
+
+static inline void stream_cmd(stream_t *st, uint8_t command) {
+    st->buf[st->len++] = CTRL_CMD_SINGLE;
+    st->buf[st->len++] = command;
+}
+
+static inline void stream_data(stream_t *st) {
+    st->buf[st->len++] = CTRL_DATA;
+}
 
 inline static void swap(uint8_t *a, uint8_t *b) {
     uint8_t *t=a;
@@ -21,89 +46,913 @@ int getOffset(char c){
     return (int)(((int)c - 32) * bytes_per_char);
 };
 
+static inline void mark_dirty(sh1106_dirty_t *dirty, uint8_t page, uint8_t x0, uint8_t x1) {
+    if(!(dirty->pages & (1 << page))){
+        dirty->pages |= (1 << page);
+        dirty->min[page] = x0;
+        dirty->max[page] = x1;
+        return;
+    }
+    if(x0 < dirty->min[page]) dirty->min[page] = x0;
+    if(x1 > dirty->max[page]) dirty->max[page] = x1;
+}
+
+// Everything SH1106_init and the on/off, contrast, pump, inverse and scroll setters leave in the
+// panel registers
+static void send_config(sh1106_t *sh1106) {
+    const uint8_t cmds[] = {
+        SET_CHARGE_PUMP, sh1106->charge_pump ? CHARGE_PUMP_ON : CHARGE_PUMP_OFF,
+        SET_SEG_REMAP | 0x01, //flip left-right
+        SET_SCAN_DIR | 0x08,  //flip top-bottom
+        SET_CONTRAST, sh1106->contrast,
+        SET_NORM_INV | (sh1106->inverse ? 0x01 : 0x00),
+        SET_START_LINE | sh1106->start_line,
+        SET_DISP_OFFSET, sh1106->display_offset,
+        SET_DISP | (sh1106->display_on ? 0x01 : 0x00),
+    };
+    SH1106_Write_CMDs(sh1106, cmds, sizeof(cmds));
+}
+
 void SH1106_init(sh1106_t *sh1106, i2c_inst_t *i2c, uint8_t address, uint8_t width, uint8_t height) {
+    sh1106->i2c = i2c;
     sh1106->address = address;
+    SH1106_initTransport(sh1106, &sh1106_i2c_transport, width, height);
+}
+
+void SH1106_initTransport(sh1106_t *sh1106, const sh1106_transport_t *transport, uint8_t width, uint8_t height) {
+    if(width > SH1106_MAX_WIDTH){
+        width = SH1106_MAX_WIDTH;
+    }
+    if(height > SH1106_MAX_HEIGHT){
+        height = SH1106_MAX_HEIGHT;
+    }
+    sh1106->transport = transport;
     sh1106->width = width;
     sh1106->height = height;
     sh1106->pages = height / 8;
-    sh1106->i2c = i2c;
-    sh1106->buffer = (uint8_t **) pageBuffer;
-    SH1106_Write_CMD(sh1106, SET_DISP | 0x01);
-    for(uint8_t i = 0; i < 8; i++){ //dark screen
-        for(uint8_t j = 0; j < 128; j++){
-            pageBuffer[i][j] = 0x00;
-        }
+    sh1106->col_offset = (132 - width) / 2; //panel is centred in the 132-column RAM
+    sh1106->front = sh1106->fb[0];
+    sh1106->back = sh1106->fb[1];
+    SH1106_resetViewport(sh1106);
+    sh1106->contrast = 0x80;
+    sh1106->display_on = true;
+    sh1106->charge_pump = true;
+    sh1106->inverse = false;
+    sh1106->start_line = 0;
+    sh1106->display_offset = 0;
+    sh1106->dirty.pages = 0;
+    sh1106->pending.pages = 0;
+    SH1106_invalidate(sh1106); //first draw sends everything
+    sh1106->bytes_sent = 0;
+    sh1106->bytes_saved = 0;
+    sh1106->dma_chan = -1;
+    sh1106->async_state = SH1106_ASYNC_IDLE;
+    sh1106->async_pending = false;
+    sh1106->async_cb = NULL;
+    sh1106->async_user = NULL;
+    sh1106->async_len = 0;
+    sh1106->async_errors = 0;
+    sh1106->bus_errors = 0;
+    sh1106->transactions = 0;
+    sh1106->glyph_blits = 0;
+    sh1106->online = true;
+    memset(sh1106->fb, 0x00, sizeof(sh1106->fb)); //dark screen
+    send_config(sh1106);
+}
+
+// Brings a panel that lost its configuration (bus fault, brown-out, reseated module) back in
+// line with this instance: replays the setup and queues the whole frame for the next draw.
+bool SH1106_reinit(sh1106_t *sh1106) {
+    sh1106->online = true;
+    send_config(sh1106);
+    SH1106_invalidate(sh1106);
+    return sh1106->online;
+}
+
+void SH1106_setContrast(sh1106_t *sh1106, uint8_t contrast) {
+    const uint8_t cmds[] = {SET_CONTRAST, contrast};
+    SH1106_Write_CMDs(sh1106, cmds, sizeof(cmds));
+    sh1106->contrast = contrast;
+}
+
+// Display off keeps the RAM: frames drawn meanwhile show up when it is turned back on.
+void SH1106_displayOn(sh1106_t *sh1106, bool on) {
+    SH1106_Write_CMD(sh1106, SET_DISP | (on ? 0x01 : 0x00));
+    sh1106->display_on = on;
+}
+
+void SH1106_setChargePump(sh1106_t *sh1106, bool on) {
+    const uint8_t cmds[] = {SET_CHARGE_PUMP, on ? CHARGE_PUMP_ON : CHARGE_PUMP_OFF};
+    SH1106_Write_CMDs(sh1106, cmds, sizeof(cmds));
+    sh1106->charge_pump = on;
+}
+
+// Panel power down/up in one transaction: display off before the pump stops, pump on before
+// the display. The datasheet asks for ~100 ms of pump settling before display on; skipping it
+// only means the first frames come up slightly dim, and callers never block.
+void SH1106_setPower(sh1106_t *sh1106, bool on) {
+    const uint8_t off_cmds[] = {SET_DISP, SET_CHARGE_PUMP, CHARGE_PUMP_OFF};
+    const uint8_t on_cmds[] = {SET_CHARGE_PUMP, CHARGE_PUMP_ON, SET_DISP | 0x01};
+    SH1106_Write_CMDs(sh1106, on ? on_cmds : off_cmds, 3);
+    sh1106->display_on = on;
+    sh1106->charge_pump = on;
+}
+
+// Inverts the whole panel in its output stage: one command byte, RAM and framebuffer stay
+// as they are, so flashing the screen costs no redraw and no frame traffic.
+void SH1106_setInverse(sh1106_t *sh1106, bool on) {
+    SH1106_Write_CMD(sh1106, SET_NORM_INV | (on ? 0x01 : 0x00));
+    sh1106->inverse = on;
+}
+
+// Hardware scrolling: both only change which RAM row is shown first, so content moves
+// (wrapping around the 64 rows) with one command and no framebuffer traffic.
+void SH1106_setStartLine(sh1106_t *sh1106, uint8_t line) {
+    SH1106_Write_CMD(sh1106, SET_START_LINE | (line & 0x3F));
+    sh1106->start_line = line & 0x3F;
+}
+
+void SH1106_setDisplayOffset(sh1106_t *sh1106, uint8_t offset) {
+    const uint8_t cmds[] = {SET_DISP_OFFSET, offset & 0x3F};
+    SH1106_Write_CMDs(sh1106, cmds, sizeof(cmds));
+    sh1106->display_offset = offset & 0x3F;
+}
+
+// True while another instance's DMA frame owns the I2C block this panel is on.
+static bool bus_taken(sh1106_t *sh1106) {
+    if(sh1106->transport != &sh1106_i2c_transport){
+        return false;
+    }
+    sh1106_t *owner = busOwner[i2c_hw_index(sh1106->i2c)];
+    if(owner == NULL || owner == sh1106){
+        return false;
     }
-    SH1106_Write_CMD(sh1106, SET_SEG_REMAP | 0x01); //flip left-right
-    SH1106_Write_CMD(sh1106, SET_SCAN_DIR | 0x08);  //flip top-bottom
+    SH1106_poll(owner);
+    return busOwner[i2c_hw_index(sh1106->i2c)] != NULL;
+}
+
+static void bus_wait(sh1106_t *sh1106) {
+    while(SH1106_busy(sh1106) || bus_taken(sh1106)){ //blocking transfers must not interleave with a DMA frame
+        tight_loop_contents();
+    }
+}
+
+// Waits for the bus and books a failed transfer; false when the panel is (now) offline.
+static bool tx_begin(sh1106_t *sh1106) {
+    bus_wait(sh1106);
+    return sh1106->online; //writes are dropped until SH1106_reinit
+}
+
+static void tx_end(sh1106_t *sh1106, bool ok) {
+    if(!ok){
+        sh1106->bus_errors++;
+        sh1106->online = false;
+    }
+}
+
+static void send_cmds(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    if(tx_begin(sh1106)){
+        tx_end(sh1106, sh1106->transport->write_cmds(sh1106, commands, n));
+    }
+}
+
+// Sends front-buffer columns [x, x + n) of a page with their page/column setup.
+static void send_run(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    if(!tx_begin(sh1106)){
+        return;
+    }
+    const sh1106_transport_t *tr = sh1106->transport;
+    if(tr->write_run){
+        tx_end(sh1106, tr->write_run(sh1106, page, x, n));
+        return;
+    }
+    uint8_t col = x + sh1106->col_offset;
+    const uint8_t setup[] = {SET_PAGE_ADDR | page, LOW_COL_ADDR | (col & 0x0F), HIGH_COL_ADDR | (col >> 4)};
+    tx_end(sh1106, tr->write_cmds(sh1106, setup, sizeof(setup)) &&
+                   tr->write_data(sh1106, &sh1106->front[page][ROW_HEADER + x], n));
+}
+
+// ---- I2C transport: every transaction starts with a control byte (CTRL_*) ----
+
+static bool i2c_write(sh1106_t *sh1106, const uint8_t *buffer, size_t len) {
+    sh1106->bytes_sent += len;
+    sh1106->transactions++;
+    return i2c_write_timeout_us(sh1106->i2c, sh1106->address, buffer, len, false, TIMEOUT_US(len)) == (int)len;
+}
+
+static bool i2c_write_cmds(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    uint8_t buffer[1 + SH1106_MAX_CMDS];
+    bool ok = true;
+    while(ok && n > 0){
+        size_t k = n < SH1106_MAX_CMDS ? n : SH1106_MAX_CMDS;
+        buffer[0] = k == 1 ? CTRL_CMD_SINGLE : CTRL_CMD_STREAM;
+        memcpy(&buffer[1], commands, k);
+        ok = i2c_write(sh1106, buffer, k + 1);
+        commands += k;
+        n -= k;
+    }
+    return ok;
+}
+
+// data[-1] must be writable: it receives the control byte (framebuffer rows reserve it).
+static bool i2c_write_data(sh1106_t *sh1106, const uint8_t *data, size_t n) {
+    uint8_t *buffer = (uint8_t *)data - 1;
+    buffer[0] = CTRL_DATA;
+    return i2c_write(sh1106, buffer, n + 1);
+}
+
+static void i2c_dma_push(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n);
+static void i2c_dma_start(sh1106_t *sh1106);
+static int i2c_dma_step(sh1106_t *sh1106);
+static uint8_t *patch_header(sh1106_t *sh1106, uint8_t page, uint8_t x0, uint8_t saved[ROW_HEADER]);
+static inline void restore_header(sh1106_t *sh1106, uint8_t page, uint8_t x0, const uint8_t saved[ROW_HEADER]);
+
+// Setup and data in one transaction, straight from the row (see patch_header).
+static bool i2c_write_run(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    uint8_t saved[ROW_HEADER];
+    bool ok = i2c_write(sh1106, patch_header(sh1106, page, x, saved), PAGE_COST(n));
+    restore_header(sh1106, page, x, saved);
+    return ok;
+}
+
+// NOP must be ACKed and the status byte read back must agree with the last display on/off.
+static bool i2c_probe(sh1106_t *sh1106) {
+    const uint8_t nop[] = {CTRL_CMD_SINGLE, SET_NOP};
+    uint8_t status = 0;
+    sh1106->transactions += 2;
+    return i2c_write_timeout_us(sh1106->i2c, sh1106->address, nop, sizeof(nop), false,
+                                TIMEOUT_US(sizeof(nop))) == sizeof(nop) &&
+           i2c_read_timeout_us(sh1106->i2c, sh1106->address, &status, 1, false, TIMEOUT_US(1)) == 1 &&
+           !(status & STATUS_DISP_OFF) == sh1106->display_on;
+}
+
+const sh1106_transport_t sh1106_i2c_transport = {
+    .write_cmds = i2c_write_cmds,
+    .write_data = i2c_write_data,
+    .write_run = i2c_write_run,
+    .probe = i2c_probe,
+    .queue_run = i2c_dma_push,
+    .start = i2c_dma_start,
+    .step = i2c_dma_step,
+};
+
+// Standard I2C bus clear for a slave stuck mid-byte holding SDA low: up to 9 SCL pulses until
+// it lets go, then a STOP. Pins are driven open-drain from SIO and handed back to the I2C
+// block, which the caller should re-initialise (i2c_init) afterwards.
+void SH1106_busRecover(uint sda_pin, uint scl_pin) {
+    gpio_init(sda_pin);
+    gpio_init(scl_pin);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+    gpio_put(sda_pin, 0); //output low when the direction is out, released (pulled up) when in
+    gpio_put(scl_pin, 0);
+    busy_wait_us_32(5);
+    for(int i = 0; i < 9 && !gpio_get(sda_pin); i++){
+        gpio_set_dir(scl_pin, GPIO_OUT);
+        busy_wait_us_32(5);
+        gpio_set_dir(scl_pin, GPIO_IN);
+        busy_wait_us_32(5);
+    }
+    gpio_set_dir(scl_pin, GPIO_OUT); //STOP: SDA rises while SCL is high
+    gpio_set_dir(sda_pin, GPIO_OUT);
+    busy_wait_us_32(5);
+    gpio_set_dir(scl_pin, GPIO_IN);
+    busy_wait_us_32(5);
+    gpio_set_dir(sda_pin, GPIO_IN);
+    busy_wait_us_32(5);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+}
+
+// Checks the panel answers at the current bus speed (always true on write-only buses).
+// Does not touch `online`.
+bool SH1106_probe(sh1106_t *sh1106) {
+    if(!sh1106->transport->probe){
+        return true;
+    }
+    bus_wait(sh1106);
+    bool ok = sh1106->transport->probe(sh1106);
+    if(!ok){
+        sh1106->bus_errors++;
+    }
+    return ok;
 }
 
 void SH1106_Write_CMD(sh1106_t *sh1106, uint8_t command) {
-    uint8_t buffer[2];
-    buffer[0] = 0x80;
-    buffer[1] = command;
-    i2c_write_blocking(sh1106->i2c, sh1106->address, buffer, 2, false);
+    send_cmds(sh1106, &command, 1);
+}
+
+void SH1106_Write_CMDs(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    send_cmds(sh1106, commands, n);
 }
-void SH1106_Write_Data(sh1106_t *sh1106, uint8_t* data) {
-    size_t bufsize = sh1106->width+1;
-    uint8_t broadCastBuffer[bufsize];
-    broadCastBuffer[0] = 0x40;
-    for (int i = 0; i < sh1106->width; i++) {
-        broadCastBuffer[i+1] = data[i];
+// Copies through a bounce buffer (the transports want data[-1] writable), one page row at a
+// time; the panel's column pointer carries on across the chunks.
+void SH1106_Write_Data(sh1106_t *sh1106, uint8_t* data, uint8_t len) {
+    uint8_t buffer[1 + SH1106_MAX_WIDTH];
+    for(uint8_t sent = 0; sent < len && tx_begin(sh1106); ){
+        uint8_t n = len - sent < SH1106_MAX_WIDTH ? len - sent : SH1106_MAX_WIDTH;
+        memcpy(&buffer[1], &data[sent], n);
+        tx_end(sh1106, sh1106->transport->write_data(sh1106, &buffer[1], n));
+        sent += n;
     }
-    i2c_write_blocking(sh1106->i2c, sh1106->address, broadCastBuffer, bufsize, false);
 }
 
-void SH1106_draw(sh1106_t *sh1106){
+// Clamps the dirty span of a page to the panel; false if the page is clean.
+static bool span_of(const sh1106_t *sh1106, const sh1106_dirty_t *dirty, uint8_t page, uint8_t *x0, uint8_t *len) {
+    if(!(dirty->pages & (1 << page))){
+        return false;
+    }
+    uint8_t x1 = dirty->max[page];
+    if(x1 >= sh1106->width){
+        x1 = sh1106->width - 1;
+    }
+    *x0 = dirty->min[page];
+    *len = x1 - *x0 + 1;
+    return true;
+}
+
+void SH1106_invalidate(sh1106_t *sh1106){
+    sh1106->shadow_valid = false;
     for(uint8_t page = 0; page < sh1106->pages; page++){
-        SH1106_Write_CMD(sh1106, SET_PAGE_ADDR | page);
-        SH1106_Write_CMD(sh1106, LOW_COL_ADDR | 0x02);
-        SH1106_Write_CMD(sh1106, HIGH_COL_ADDR | 0x00);
-        SH1106_Write_Data(sh1106, pageBuffer[page]);
+        mark_dirty(&sh1106->pending, page, 0, sh1106->width - 1);
     }
 }
 
-void SH1106_drawPixel(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t color){
-    if(x > sh1106->width || y > sh1106->height){
+void SH1106_present(sh1106_t *sh1106){
+    // The old front becomes the back buffer: a zero-copy frame must be done reading it
+    while(sh1106->transport->zero_copy && sh1106->async_state != SH1106_ASYNC_IDLE){
+        SH1106_poll(sh1106);
+    }
+    uint8_t (*drawn)[SH1106_ROW_BYTES] = sh1106->back;
+    sh1106->back = sh1106->front;
+    sh1106->front = drawn;
+    // The new back buffer is one frame behind: catch it up on the spans just drawn
+    uint8_t x0, len;
+    for(uint8_t page = 0; page < sh1106->pages; page++){
+        if(!span_of(sh1106, &sh1106->dirty, page, &x0, &len)){
+            continue;
+        }
+        memcpy(&sh1106->back[page][ROW_HEADER + x0], &sh1106->front[page][ROW_HEADER + x0], len);
+        mark_dirty(&sh1106->pending, page, x0, x0 + len - 1);
+    }
+    sh1106->dirty.pages = 0;
+}
+
+// Writes the page/column setup of a span into the ROW_HEADER bytes in front of it, so the
+// whole transaction is contiguous in the row. For x0 > 0 those bytes are pixels of the
+// columns to the left: they are saved in `saved` and must be put back with restore_header.
+static uint8_t *patch_header(sh1106_t *sh1106, uint8_t page, uint8_t x0, uint8_t saved[ROW_HEADER]) {
+    stream_t st = { &sh1106->front[page][x0], 0 };
+    uint8_t col = x0 + sh1106->col_offset;
+    memcpy(saved, st.buf, ROW_HEADER);
+    stream_cmd(&st, SET_PAGE_ADDR | page);
+    stream_cmd(&st, LOW_COL_ADDR | (col & 0x0F));
+    stream_cmd(&st, HIGH_COL_ADDR | (col >> 4));
+    stream_data(&st);
+    return st.buf;
+}
+
+static inline void restore_header(sh1106_t *sh1106, uint8_t page, uint8_t x0, const uint8_t saved[ROW_HEADER]) {
+    memcpy(&sh1106->front[page][x0], saved, ROW_HEADER);
+}
+
+// Queues one run as an I2C transaction of IC_DATA_CMD words; STOP on the last byte makes the
+// controller issue a fresh START for the next transaction in the same DMA stream.
+static void i2c_dma_push(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    uint8_t saved[ROW_HEADER];
+    const uint8_t *bytes = patch_header(sh1106, page, x, saved);
+    size_t len = PAGE_COST(n);
+    for(size_t i = 0; i < len; i++){
+        sh1106->stream[sh1106->async_len++] = bytes[i] | ((i == len - 1) ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+    }
+    restore_header(sh1106, page, x, saved);
+    sh1106->bytes_sent += len;
+    sh1106->transactions++;
+}
+
+// Next run of bytes in [*x, end] where the front buffer differs from what the panel shows.
+// Runs separated by at most MERGE_GAP equal bytes are merged: resending the gap is cheaper
+// than the page/column setup of a new transaction.
+static bool next_run(sh1106_t *sh1106, uint8_t page, uint8_t *x, uint8_t end, uint8_t *start, uint8_t *len) {
+    const uint8_t *fr = &sh1106->front[page][ROW_HEADER];
+    const uint8_t *shadow = sh1106->shadow[page];
+    if(!sh1106->shadow_valid){ //panel content unknown: everything differs
+        if(*x > end){
+            return false;
+        }
+        *start = *x;
+        *len = end - *x + 1;
+        *x = end + 1;
+        return true;
+    }
+    uint16_t i = *x;
+    while(i <= end && fr[i] == shadow[i]){
+        i++;
+    }
+    if(i > end){
+        *x = end + 1;
+        return false;
+    }
+    uint8_t last = i;
+    uint8_t gap = 0;
+    *start = i;
+    for(i++; i <= end && gap <= MERGE_GAP; i++){
+        if(fr[i] != shadow[i]){
+            last = i;
+            gap = 0;
+        }else{
+            gap++;
+        }
+    }
+    *len = last - *start + 1;
+    *x = last + 1;
+    return true;
+}
+
+// Sends the changed runs of every pending span through `emit` (blocking or DMA stream).
+static void flush_pending(sh1106_t *sh1106, void (*emit)(sh1106_t *, uint8_t, uint8_t, uint8_t)) {
+    uint8_t x0, len;
+    for(uint8_t page = 0; page < sh1106->pages; page++){
+        uint16_t cost = 0;
+        if(span_of(sh1106, &sh1106->pending, page, &x0, &len)){
+            uint8_t x = x0, start, n;
+            while(next_run(sh1106, page, &x, x0 + len - 1, &start, &n)){
+                emit(sh1106, page, start, n);
+                memcpy(&sh1106->shadow[page][start], &sh1106->front[page][ROW_HEADER + start], n);
+                cost += PAGE_COST(n);
+            }
+        }
+        sh1106->bytes_saved += PAGE_COST(sh1106->width) - cost;
+    }
+    sh1106->pending.pages = 0;
+    sh1106->shadow_valid = true;
+}
+
+// A frame cut off by a bus fault: its spans go back to pending, sent whole as the shadow
+// no longer says what reached the panel.
+static void remark(sh1106_t *sh1106, const sh1106_dirty_t *spans) {
+    for(uint8_t page = 0; page < sh1106->pages; page++){
+        if(spans->pages & (1 << page)){
+            mark_dirty(&sh1106->pending, page, spans->min[page], spans->max[page]);
+        }
+    }
+    sh1106->shadow_valid = false;
+}
+
+void SH1106_draw(sh1106_t *sh1106){
+    if(!sh1106->online){
+        return; //SH1106_reinit resends the whole frame
+    }
+    sh1106_dirty_t spans = sh1106->pending;
+    flush_pending(sh1106, send_run);
+    if(!sh1106->online){
+        remark(sh1106, &spans);
+    }
+}
+
+static void async_finish(sh1106_t *sh1106) {
+    sh1106->async_state = SH1106_ASYNC_IDLE;
+    if(sh1106->transport == &sh1106_i2c_transport && busOwner[i2c_hw_index(sh1106->i2c)] == sh1106){
+        busOwner[i2c_hw_index(sh1106->i2c)] = NULL;
+    }
+    if(sh1106->async_cb){
+        sh1106->async_cb(sh1106, sh1106->async_user);
+    }
+}
+
+static void async_start(sh1106_t *sh1106) {
+    uint32_t queued = sh1106->bytes_sent;
+    sh1106->async_pending = false;
+    sh1106->async_len = 0;
+    sh1106->async_spans = sh1106->pending;
+    flush_pending(sh1106, sh1106->transport->queue_run);
+    queued = sh1106->bytes_sent - queued;
+    if(queued == 0){
+        async_finish(sh1106);
         return;
     }
-    if(color == 0){
-        pageBuffer[y/8][x] &= ~(1 << (y % 8));
+    sh1106->async_state = SH1106_ASYNC_BUSY;
+    sh1106->async_deadline = make_timeout_time_us(TIMEOUT_US(queued));
+    sh1106->transport->start(sh1106);
+}
+
+static void i2c_dma_start(sh1106_t *sh1106) {
+    i2c_hw_t *hw = i2c_get_hw(sh1106->i2c);
+    hw->enable = 0;
+    hw->tar = sh1106->address;
+    hw->enable = 1;
+    (void) hw->clr_tx_abrt;
+
+    if(sh1106->dma_chan < 0){
+        sh1106->dma_chan = dma_claim_unused_channel(true);
+    }
+    dma_channel_config cfg = dma_channel_get_default_config(sh1106->dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, i2c_get_dreq(sh1106->i2c, true));
+    busOwner[i2c_hw_index(sh1106->i2c)] = sh1106;
+    dma_channel_configure(sh1106->dma_chan, &cfg, &hw->data_cmd, sh1106->stream, sh1106->async_len, true);
+}
+
+bool SH1106_draw_async(sh1106_t *sh1106, sh1106_done_cb cb, void *user){
+    SH1106_poll(sh1106);
+    sh1106->async_cb = cb;
+    sh1106->async_user = user;
+    if(!sh1106->online){
+        return false;
+    }
+    if(!sh1106->transport->queue_run){ //no DMA path on this bus: send it now
+        SH1106_draw(sh1106);
+        if(cb){
+            cb(sh1106, user);
+        }
+        return true;
+    }
+    if(sh1106->async_state != SH1106_ASYNC_IDLE || bus_taken(sh1106)){
+        sh1106->async_pending = true; //SH1106_poll sends it once this frame and the bus are done
+        return false;
+    }
+    async_start(sh1106);
+    return true;
+}
+
+void SH1106_poll(sh1106_t *sh1106){
+    if(sh1106->async_state != SH1106_ASYNC_IDLE){
+        async_step(sh1106);
+    }
+    if(!sh1106->online){
+        sh1106->async_pending = false;
+    }
+    if(sh1106->async_state == SH1106_ASYNC_IDLE && sh1106->async_pending && !bus_taken(sh1106)){
+        async_start(sh1106);
+    }
+}
+
+bool SH1106_busy(sh1106_t *sh1106){
+    SH1106_poll(sh1106);
+    return sh1106->async_state != SH1106_ASYNC_IDLE || sh1106->async_pending;
+}
+
+void SH1106_draw_all(sh1106_t *const *panels, size_t n){
+    for(size_t i = 0; i < n; i++){ //panels on different buses transfer in parallel
+        SH1106_draw_async(panels[i], panels[i]->async_cb, panels[i]->async_user);
+    }
+    bool busy;
+    do{
+        busy = false;
+        for(size_t i = 0; i < n; i++){
+            busy |= SH1106_busy(panels[i]);
+        }
+    }while(busy);
+}
+
+static void async_step(sh1106_t *sh1106){
+    int state = sh1106->transport->step(sh1106);
+    if(state < 0){ //frame dropped, the bus needs recovery
+        sh1106->async_errors++;
+        sh1106->online = false;
+        remark(sh1106, &sh1106->async_spans);
+        async_finish(sh1106);
+    }else if(state == SH1106_ASYNC_IDLE){
+        async_finish(sh1106);
     }else{
-        pageBuffer[y/8][x] |= (1 << (y % 8));
+        sh1106->async_state = state;
+    }
+}
+
+static int i2c_dma_step(sh1106_t *sh1106){
+    i2c_hw_t *hw = i2c_get_hw(sh1106->i2c);
+    bool aborted = hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS; //NACK or arbitration lost
+    if(aborted || time_reached(sh1106->async_deadline)){
+        dma_channel_abort(sh1106->dma_chan);
+        (void) hw->clr_tx_abrt;
+        return -1;
     }
+    int state = sh1106->async_state;
+    if(state == SH1106_ASYNC_BUSY && !dma_channel_is_busy(sh1106->dma_chan)){
+        state = SH1106_ASYNC_DRAIN; //DMA done, the FIFO still holds the tail
+    }
+    if(state == SH1106_ASYNC_DRAIN &&
+       (hw->status & I2C_IC_STATUS_TFE_BITS) && !(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)){
+        state = SH1106_ASYNC_IDLE;
+    }
+    return state;
+}
 
+void SH1106_setViewport(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height){
+    sh1106_viewport_t *vp = &sh1106->viewport;
+    vp->x0 = x < sh1106->width ? x : sh1106->width;
+    vp->y0 = y < sh1106->height ? y : sh1106->height;
+    vp->x1 = x + width < sh1106->width ? x + width : sh1106->width;
+    vp->y1 = y + height < sh1106->height ? y + height : sh1106->height;
 }
 
-void SH1106_draw_hline(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t w, uint8_t color){
-    if(x > sh1106->width || y > sh1106->height){
+void SH1106_resetViewport(sh1106_t *sh1106){
+    SH1106_setViewport(sh1106, 0, 0, sh1106->width, sh1106->height);
+}
+
+static inline bool in_viewport(const sh1106_t *sh1106, int16_t x, int16_t y) {
+    const sh1106_viewport_t *vp = &sh1106->viewport;
+    return x >= vp->x0 && x < vp->x1 && y >= vp->y0 && y < vp->y1;
+}
+
+// Unchecked pixel write, for callers that already clipped
+static inline void plot(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t color) {
+    uint8_t *b = &FB(sh1106, y / 8, x);
+    uint8_t v = color ? *b | (1 << (y % 8)) : *b & ~(1 << (y % 8));
+    if(v != *b){
+        *b = v;
+        mark_dirty(&sh1106->dirty, y / 8, x, x);
+    }
+}
+
+void SH1106_drawPixel(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t color){
+    if(!in_viewport(sh1106, x, y)){
         return;
     }
-    if((x + w) > sh1106->width){
-        w = sh1106->width - x;
+    plot(sh1106, x, y, color);
+}
+
+// Sets (color != 0) or clears the `mask` bits of n bytes of a page, marking only the columns
+// that really change.
+static void fill_page(sh1106_t *sh1106, uint8_t page, uint8_t x0, uint8_t n, uint8_t mask, uint8_t color) {
+    uint8_t *row = &FB(sh1106, page, x0);
+    int16_t first = -1, last = -1;
+    for(uint8_t i = 0; i < n; i++){
+        uint8_t b = color ? row[i] | mask : row[i] & ~mask;
+        if(b != row[i]){
+            row[i] = b;
+            if(first < 0) first = i;
+            last = i;
+        }
     }
-    for(uint8_t i = 0; i < w; i++){
-        SH1106_drawPixel(sh1106, x + i, y, color);
+    if(first >= 0){
+        mark_dirty(&sh1106->dirty, page, x0 + first, x0 + last);
     }
+}
+
+// Clips once against the viewport, then works on whole page bytes: masked bytes on the top and
+// bottom pages of the rectangle, full bytes in between.
+void SH1106_fillRect(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color){
+    const sh1106_viewport_t *vp = &sh1106->viewport;
+    uint8_t x0 = x > vp->x0 ? x : vp->x0;
+    uint8_t y0 = y > vp->y0 ? y : vp->y0;
+    int16_t x1 = x + width < vp->x1 ? x + width : vp->x1;
+    int16_t y1 = (y + height < vp->y1 ? y + height : vp->y1) - 1;
+    if(x0 >= x1 || y0 > y1){
+        return;
+    }
+    for(uint8_t page = y0 / 8; page <= y1 / 8; page++){
+        uint8_t mask = 0xFF;
+        if(page == y0 / 8){
+            mask &= 0xFF << (y0 % 8);
+        }
+        if(page == y1 / 8){
+            mask &= 0xFF >> (7 - y1 % 8);
+        }
+        fill_page(sh1106, page, x0, x1 - x0, mask, color);
+    }
+}
+
+void SH1106_clearRect(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height){
+    SH1106_fillRect(sh1106, x, y, width, height, 0);
+}
+
+void SH1106_draw_hline(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t w, uint8_t color){
+    SH1106_fillRect(sh1106, x, y, w, 1, color);
 };
 
+void SH1106_drawVLine(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t h, uint8_t color){
+    SH1106_fillRect(sh1106, x, y, 1, h, color);
+}
 
 void SH1106_clear(sh1106_t *sh1106){
-    for(uint8_t i = 0; i < 8; i++){ //dark screen
-        for(uint8_t j = 0; j < 128; j++){
-            pageBuffer[i][j] = 0x00;
+    for(uint8_t i = 0; i < sh1106->pages; i++){ //dark screen
+        for(uint8_t j = 0; j < sh1106->width; j++){
+            if(FB(sh1106, i, j)){
+                FB(sh1106, i, j) = 0x00;
+                mark_dirty(&sh1106->dirty, i, j, j);
+            }
         }
     }
 };
 
 
-void SH1106_drawRectangle(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color) {
-    for(uint8_t i=0; i<width; ++i)
-        for(uint8_t j=0; j<height; ++j)
-            SH1106_drawPixel(sh1106, x+i, y+j, color);
+// Writes n bytes of src (shifted into place) into a page under `mask`, marking only the
+// columns that really change. shift > 0 moves bits down the page, shift < 0 up.
+static void blit_page(sh1106_t *sh1106, uint8_t page, uint8_t x0, uint8_t n, const uint8_t *src,
+                      int8_t shift, uint8_t mask, bool invert) {
+    uint8_t *row = &FB(sh1106, page, x0);
+    int16_t first = -1, last = -1;
+    for(uint8_t i = 0; i < n; i++){
+        uint8_t bits = shift >= 0 ? (uint8_t)(src[i] << shift) : (uint8_t)(src[i] >> -shift);
+        if(invert){
+            bits = ~bits;
+        }
+        uint8_t b = (row[i] & ~mask) | (bits & mask);
+        if(b != row[i]){
+            row[i] = b;
+            if(first < 0) first = i;
+            last = i;
+        }
+    }
+    if(first >= 0){
+        mark_dirty(&sh1106->dirty, page, x0 + first, x0 + last);
+    }
+}
+
+// Blits a page-major 1bpp image (`pages` rows of w column bytes, LSB on top) at any y.
+// The image is opaque: set bits become `color`, clear bits the opposite.
+static void blit(sh1106_t *sh1106, int16_t x, int16_t y, uint8_t w, uint8_t pages, const uint8_t *src, uint8_t color) {
+    int16_t x0 = x < 0 ? 0 : x;
+    int16_t x1 = x + w > sh1106->width ? sh1106->width : x + w;
+    if(x0 >= x1 || y < 0){
+        return;
+    }
+    src += x0 - x;
+    for(uint8_t p = 0; p < pages; p++, src += w){
+        int16_t top = y + 8 * p;
+        uint8_t page = top / 8, shift = top % 8;
+        if(page < sh1106->pages){
+            blit_page(sh1106, page, x0, x1 - x0, src, shift, 0xFF << shift, color == 0);
+        }
+        if(shift && page + 1 < sh1106->pages){
+            blit_page(sh1106, page + 1, x0, x1 - x0, src, shift - 8, 0xFF >> (8 - shift), color == 0);
+        }
+    }
+}
+
+// Places one byte of an image being decoded at column x of image page p, same rules as blit.
+static inline void blit_byte(sh1106_t *sh1106, int16_t x, int16_t y, uint8_t p, uint8_t b, bool invert) {
+    if(x < 0 || x >= sh1106->width){
+        return;
+    }
+    int16_t top = y + 8 * p;
+    uint8_t page = top / 8, shift = top % 8;
+    if(page < sh1106->pages){
+        blit_page(sh1106, page, x, 1, &b, shift, 0xFF << shift, invert);
+    }
+    if(shift && page + 1 < sh1106->pages){
+        blit_page(sh1106, page + 1, x, 1, &b, shift - 8, 0xFF >> (8 - shift), invert);
+    }
+}
 
+// Like blit, but src is compressed by tools/asset_encode.py. Packets are decoded straight
+// into the back buffer, one byte at a time:
+//   00nnnnnn n+1 literal bytes follow    01nnnnnn n+1 x 0x00
+//   10nnnnnn n+1 x 0xFF                  11nnnnnn next byte repeated n+2 times
+static void blit_rle(sh1106_t *sh1106, int16_t x, int16_t y, uint8_t w, uint8_t pages, const uint8_t *src, uint8_t color) {
+    if(x >= sh1106->width || x + w <= 0 || y < 0){
+        return;
+    }
+    uint8_t col = 0, p = 0;
+    while(p < pages){
+        uint8_t header = *src++;
+        uint8_t n = (header & 0x3F) + 1;
+        uint8_t value = header & 0x40 ? 0x00 : 0xFF;
+        bool literal = (header & 0xC0) == 0x00;
+        if((header & 0xC0) == 0xC0){
+            value = *src++;
+            n++;
+        }
+        while(n-- && p < pages){
+            blit_byte(sh1106, x + col, y, p, literal ? *src++ : value, color == 0);
+            if(++col == w){
+                col = 0;
+                p++;
+            }
+        }
+    }
+}
+
+void SH1106_drawRectangle(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color) {
+    SH1106_fillRect(sh1106, x, y, width, height, color);
 };
 
+// Walks a line along its major axis a: pixel k is (a0 + sa*k, b0 + sb*m) with
+// m = floor((2*k*db + da) / (2*da)). The range of k inside the viewport is solved before
+// the loop, which then only has to step the error term.
+static void line_major(sh1106_t *sh1106, bool steep, int16_t a0, int16_t b0, int16_t da, int16_t db,
+                       int8_t sa, int8_t sb, int16_t amin, int16_t amax, int16_t bmin, int16_t bmax, uint8_t color) {
+    int32_t klo = sa > 0 ? amin - a0 : a0 - amax;
+    int32_t khi = sa > 0 ? amax - a0 : a0 - amin;
+    int32_t mlo = sb > 0 ? bmin - b0 : b0 - bmax;
+    int32_t mhi = sb > 0 ? bmax - b0 : b0 - bmin;
+    if(klo < 0) klo = 0;
+    if(khi > da) khi = da;
+    if(mhi < 0 || mlo > db){
+        return;
+    }
+    if(db == 0){
+        if(mlo > 0){
+            return;
+        }
+    }else{
+        if(mlo > 0){
+            int32_t k = (2 * (int32_t)da * mlo - da + 2 * db - 1) / (2 * db);
+            if(k > klo) klo = k;
+        }
+        int32_t k = (2 * (int32_t)da * (mhi + 1) - da - 1) / (2 * db);
+        if(k < khi) khi = k;
+    }
+    if(klo > khi){
+        return;
+    }
+    int32_t num = 2 * klo * db + da;
+    int16_t m = num / (2 * da);
+    int32_t rem = num % (2 * da);
+    for(int32_t k = klo; k <= khi; k++){
+        int16_t a = a0 + sa * k, b = b0 + sb * m;
+        if(steep){
+            plot(sh1106, b, a, color);
+        }else{
+            plot(sh1106, a, b, color);
+        }
+        rem += 2 * db;
+        if(rem >= 2 * da){
+            rem -= 2 * da;
+            m++;
+        }
+    }
+}
+
+void SH1106_drawLine(sh1106_t *sh1106, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color){
+    const sh1106_viewport_t *vp = &sh1106->viewport;
+    if(vp->x0 >= vp->x1 || vp->y0 >= vp->y1){
+        return;
+    }
+    int16_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int16_t dy = y1 > y0 ? y1 - y0 : y0 - y1;
+    int8_t sx = x1 >= x0 ? 1 : -1, sy = y1 >= y0 ? 1 : -1;
+    if(dx == 0 && dy == 0){
+        if(in_viewport(sh1106, x0, y0)){
+            plot(sh1106, x0, y0, color);
+        }
+    }else if(dx >= dy){
+        line_major(sh1106, false, x0, y0, dx, dy, sx, sy, vp->x0, vp->x1 - 1, vp->y0, vp->y1 - 1, color);
+    }else{
+        line_major(sh1106, true, y0, x0, dy, dx, sy, sx, vp->y0, vp->y1 - 1, vp->x0, vp->x1 - 1, color);
+    }
+}
+
+static inline void arc_point(sh1106_t *sh1106, int16_t x, int16_t y, bool clip, uint8_t color) {
+    if(!clip || in_viewport(sh1106, x, y)){
+        plot(sh1106, x, y, color);
+    }
+}
+
+// Midpoint circle; octant n covers 45*n..45*(n+1) degrees counter-clockwise from 3 o'clock.
+// Only circles crossing the viewport edge pay for a per-pixel check.
+void SH1106_drawArc(sh1106_t *sh1106, int16_t cx, int16_t cy, uint8_t r, uint8_t octants, uint8_t color){
+    const sh1106_viewport_t *vp = &sh1106->viewport;
+    if(cx + r < vp->x0 || cx - r >= vp->x1 || cy + r < vp->y0 || cy - r >= vp->y1){
+        return;
+    }
+    bool clip = cx - r < vp->x0 || cx + r >= vp->x1 || cy - r < vp->y0 || cy + r >= vp->y1;
+    int16_t x = r, y = 0, err = 1 - r;
+    while(x >= y){
+        if(octants & 0x01) arc_point(sh1106, cx + x, cy - y, clip, color);
+        if(octants & 0x02) arc_point(sh1106, cx + y, cy - x, clip, color);
+        if(octants & 0x04) arc_point(sh1106, cx - y, cy - x, clip, color);
+        if(octants & 0x08) arc_point(sh1106, cx - x, cy - y, clip, color);
+        if(octants & 0x10) arc_point(sh1106, cx - x, cy + y, clip, color);
+        if(octants & 0x20) arc_point(sh1106, cx - y, cy + x, clip, color);
+        if(octants & 0x40) arc_point(sh1106, cx + y, cy + x, clip, color);
+        if(octants & 0x80) arc_point(sh1106, cx + x, cy + y, clip, color);
+        y++;
+        if(err < 0){
+            err += 2 * y + 1;
+        }else{
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void SH1106_drawCircle(sh1106_t *sh1106, int16_t cx, int16_t cy, uint8_t r, uint8_t color){
+    SH1106_drawArc(sh1106, cx, cy, r, SH1106_ARC_ALL, color);
+}
+
+// Row-major 1bpp bitmap, (w + 7) / 8 bytes per row, MSB on the left. Set bits are drawn in
+// `color`, clear bits leave the framebuffer alone. Rows and columns are clipped up front.
+void SH1106_drawBitmap(sh1106_t *sh1106, int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bits, uint8_t color){
+    const sh1106_viewport_t *vp = &sh1106->viewport;
+    int16_t i0 = x < vp->x0 ? vp->x0 - x : 0;
+    int16_t j0 = y < vp->y0 ? vp->y0 - y : 0;
+    int16_t i1 = x + w > vp->x1 ? vp->x1 - x : w;
+    int16_t j1 = y + h > vp->y1 ? vp->y1 - y : h;
+    uint8_t stride = (w + 7) / 8;
+    for(int16_t j = j0; j < j1; j++){
+        const uint8_t *row = bits + j * stride;
+        for(int16_t i = i0; i < i1; i++){
+            if(row[i / 8] & (0x80 >> (i % 8))){
+                plot(sh1106, x + i, y + j, color);
+            }
+        }
+    }
+}
+
 /*
 void SH1106_drawChar(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t scale, const uint8_t *font, char c, uint8_t color) {
     if(c<font[3]||c>font[4])
@@ -126,53 +975,69 @@ void SH1106_drawChar(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t scale, cons
 }
 
 */
-void SH1106_drawChar(sh1106_t * sh1106, char c, uint8_t x, uint8_t y, uint8_t color, const uint8_t* font) {
-    uint8_t i,j;
-    uint32_t index;
-    if (c == ' '){
-        index = 0;
-    }
-    else if ( c < '!' || c > '~'){
-        index = 0;
-    }
-    else{
-        index = (c - 32) * 16; // -32 ascii {!} * 16 = bytes per char
-    }
-   for (i = 0; i < FONT_HEIGHT; i++){
-       for(j = 0; j < FONT_WIDTH; j++){
-           if(x+8-j > sh1106->width){
-               return;
-           }
-           if(y+i > sh1106->height){
-               return;
-           }
-           if (font[index+i] & (1 << j)){
-               SH1106_drawPixel(sh1106, x+8-j, y + i, color);
-           }
-           else{
-                SH1106_drawPixel(sh1106, x+8-j, y + i, !color);
-           }
-       }
-
-   }
-   if(color==0){
-       SH1106_drawRectangle(sh1106, x, y, (FONT_WIDTH+1), 2, 0);
-   }
-}
-
-void SH1106_drawString(sh1106_t *sh1106, char* str, uint8_t x, uint8_t y, uint8_t color, const uint8_t* font){
+void SH1106_drawChar(sh1106_t * sh1106, char c, uint8_t x, uint8_t y, uint8_t color, const sh1106_font_t* font) {
+    uint8_t index = 0; //glyph 0 stands in for characters the font lacks
+    if(c >= font->first && c <= font->last){
+        index = font->map ? font->map[c - font->first] : c - font->first;
+    }
+    sh1106->glyph_blits++;
+    if(font->offsets){
+        blit_rle(sh1106, x, y, font->width, font->height / 8, font->glyphs + font->offsets[index], color);
+    }else{
+        const uint8_t *glyph = font->glyphs + (uint16_t)index * font->bytes_per_glyph;
+        blit(sh1106, x, y, font->width, font->height / 8, glyph, color);
+    }
+    if(color==0){
+        SH1106_drawRectangle(sh1106, x, y, font->width, 2, 0);
+    }
+}
+
+void SH1106_drawImage(sh1106_t *sh1106, int16_t x, int16_t y, const sh1106_image_t *image, uint8_t color){
+    if(image->compressed){
+        blit_rle(sh1106, x, y, image->width, image->height / 8, image->data, color);
+    }else{
+        blit(sh1106, x, y, image->width, image->height / 8, image->data, color);
+    }
+}
+
+void SH1106_drawString(sh1106_t *sh1106, char* str, uint8_t x, uint8_t y, uint8_t color, const sh1106_font_t* font){
     uint8_t i = 0;
     while(str[i] != '\0'){
-        if(x + i*(FONT_WIDTH+1) > sh1106->width){
+        if(x + i*font->width > sh1106->width){
             return;
         }
-        SH1106_drawChar(sh1106, str[i], x + i*(FONT_WIDTH+1), y, color, font);
+        // glyphs carry their own gap column, so inverted text needs no gap filling
+        SH1106_drawChar(sh1106, str[i], x + i*font->width, y, color, font);
+        i++;
+    }
+}
 
-        if(color==0){ //fill black gaps between letters if text is inverted
-            for(uint8_t j = 2; j < (FONT_HEIGHT); j++){
-                SH1106_drawPixel(sh1106, x + i*9, y + j, 1);
-            };
+// drawString for text that changes a few characters at a time (counters, clocks): only
+// cells whose character differs from the cached string are drawn, so only their columns
+// get dirty, and cells left over from a longer string are cleared. Glyphs paint their
+// whole cell, nothing is erased first. Returns the number of cells drawn or cleared.
+uint8_t SH1106_drawStringCached(sh1106_t *sh1106, sh1106_text_cache_t *cache, const char *str, uint8_t x, uint8_t y,
+                                uint8_t color, const sh1106_font_t *font){
+    if(cache->font != font || cache->x != x || cache->y != y || cache->color != color){
+        memset(cache->text, 0, sizeof(cache->text)); //somewhere else now: every cell is new
+        cache->font = font;
+        cache->x = x;
+        cache->y = y;
+        cache->color = color;
+    }
+    uint8_t cells = 0;
+    uint8_t i = 0;
+    for(; str[i] != '\0' && i < SH1106_TEXT_CACHE_LEN && x + i*font->width <= sh1106->width; i++){
+        if(cache->text[i] != str[i]){
+            SH1106_drawChar(sh1106, str[i], x + i*font->width, y, color, font);
+            cache->text[i] = str[i];
+            cells++;
         }
-        i++;
     }
+    for(; i < SH1106_TEXT_CACHE_LEN && cache->text[i] != '\0'; i++){
+        SH1106_fillRect(sh1106, x + i*font->width, y, font->width, font->height, !color);
+        cache->text[i] = '\0';
+        cells++;
+    }
+    return cells;
 }
@@ -7,10 +7,14 @@
 
 
 #include <stdio.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "pico/malloc.h"
 #include <malloc.h>
 #include "hardware/i2c.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
 
 
 #define SET_DISP 0xAE
@@ -19,23 +23,225 @@
 #define LOW_COL_ADDR 0x00
 #define HIGH_COL_ADDR 0x10
 #define SET_PAGE_ADDR 0xB0
+#define SET_START_LINE 0x40
+#define SET_DISP_OFFSET 0xD3
+#define SET_CONTRAST 0x81
+#define SET_CHARGE_PUMP 0xAD   // followed by CHARGE_PUMP_ON / CHARGE_PUMP_OFF
+#define CHARGE_PUMP_ON 0x8B
+#define CHARGE_PUMP_OFF 0x8A
+#define SET_NOP 0xE3
+#define SET_NORM_INV 0xA6      // | 0x01: inverse video (lit pixels off, dark pixels on)
+#define STATUS_DISP_OFF 0x40   // status byte (read): display is off
+
+// Largest panel an instance can hold; every sh1106_t carries buffers of this size.
+// Builds that only drive 128x64 or 128x32 panels can lower them to save RAM.
+#ifndef SH1106_MAX_WIDTH
+#define SH1106_MAX_WIDTH 132
+#endif
+#ifndef SH1106_MAX_HEIGHT
+#define SH1106_MAX_HEIGHT 64
+#endif
+#define SH1106_MAX_PAGES (SH1106_MAX_HEIGHT / 8)
+
+// Framebuffer rows reserve this many bytes in front of the pixels for the page/column
+// setup and the data control byte, so a page is sent straight from the buffer.
+#define SH1106_ROW_HEADER 7
+#define SH1106_ROW_BYTES (SH1106_ROW_HEADER + SH1106_MAX_WIDTH)
+#define SH1106_STREAM_WORDS (SH1106_MAX_PAGES * SH1106_ROW_BYTES) //worst case DMA frame
+
+// Commands per I2C transaction; longer lists passed to SH1106_Write_CMDs go out in pieces.
+#ifndef SH1106_MAX_CMDS
+#define SH1106_MAX_CMDS 16
+#endif
+
+// Bound on one blocking transfer or DMA frame of n bytes. A dead or stuck bus costs at most
+// this once: the panel is then marked offline and writes are dropped until SH1106_reinit.
+#ifndef SH1106_TIMEOUT_BASE_US
+#define SH1106_TIMEOUT_BASE_US 1000
+#endif
+#ifndef SH1106_TIMEOUT_BYTE_US
+#define SH1106_TIMEOUT_BYTE_US 100 //a byte takes 90 us at 100 kHz
+#endif
+
+#define SH1106_ASYNC_IDLE  0  // no frame in flight
+#define SH1106_ASYNC_BUSY  1  // DMA feeding the bus TX FIFO
+#define SH1106_ASYNC_DRAIN 2  // DMA done, waiting for the FIFO to empty and the last bit
+
+struct sh1106;
+typedef void (*sh1106_done_cb)(struct sh1106 *sh1106, void *user);
+
+// Bus backend of an instance, chosen at init (SH1106_init for I2C, SH1106_initSPI for SPI).
+// Drawing, dirty tracking and the shadow diff are shared; a transport only moves bytes and
+// returns false when a transfer failed.
+typedef struct sh1106_transport {
+    bool (*write_cmds)(struct sh1106 *sh1106, const uint8_t *commands, size_t n);
+    bool (*write_data)(struct sh1106 *sh1106, const uint8_t *data, size_t n); // data[-1] is writable
+    // Optional: front-buffer columns [x, x + n) of a page with their page/column setup in one
+    // go. NULL: write_cmds for the setup, then write_data.
+    bool (*write_run)(struct sh1106 *sh1106, uint8_t page, uint8_t x, uint8_t n);
+    bool (*probe)(struct sh1106 *sh1106); // optional: NULL on write-only buses
+    // Optional DMA path of SH1106_draw_async; NULL queue_run: frames are sent blocking.
+    // queue_run adds a run to the frame being built, start launches the frame, step advances
+    // it and returns the new SH1106_ASYNC_* state, or -1 when the frame failed.
+    void (*queue_run)(struct sh1106 *sh1106, uint8_t page, uint8_t x, uint8_t n);
+    void (*start)(struct sh1106 *sh1106);
+    int (*step)(struct sh1106 *sh1106);
+    bool zero_copy; // the DMA reads the queued runs from the front rows until the frame is done
+} sh1106_transport_t;
+
+typedef struct sh1106_dirty {
+    uint8_t pages;          // bit n set -> page n has a changed span
+    uint8_t min[SH1106_MAX_PAGES]; // first changed column of each dirty page
+    uint8_t max[SH1106_MAX_PAGES]; // last changed column of each dirty page
+} sh1106_dirty_t;
+
+// Bitmap font in the panel's native layout, generated by tools/font_convert.py
+typedef struct sh1106_font {
+    uint8_t width;            // cell width in columns, leading gap column included
+    uint8_t height;           // glyph height in pixels, multiple of 8
+    char first;               // first character in the table
+    char last;                // last character in the table
+    uint16_t bytes_per_glyph; // width * height / 8
+    const uint8_t *glyphs;    // per glyph: height/8 pages of `width` column bytes, LSB on top
+    const uint8_t *map;       // subset fonts: glyph of each char in [first, last]; NULL if dense
+    const uint16_t *offsets;  // compressed fonts: start of each glyph in glyphs; NULL if raw
+} sh1106_font_t;
+
+// What SH1106_drawStringCached last drew at one place. Zero it before first use and
+// whenever something else has drawn over that text.
+#define SH1106_TEXT_CACHE_LEN 16
+typedef struct sh1106_text_cache {
+    const sh1106_font_t *font;  // NULL: nothing drawn yet
+    uint8_t x;
+    uint8_t y;
+    uint8_t color;
+    char text[SH1106_TEXT_CACHE_LEN + 1];
+} sh1106_text_cache_t;
+
+// Clip rectangle of the drawing primitives, end exclusive
+typedef struct sh1106_viewport {
+    uint8_t x0;
+    uint8_t y0;
+    uint8_t x1;
+    uint8_t y1;
+} sh1106_viewport_t;
+
+// Octant bits for SH1106_drawArc, counter-clockwise from 3 o'clock
+#define SH1106_ARC_ALL   0xFF
+#define SH1106_ARC_UPPER 0x0F
+#define SH1106_ARC_LOWER 0xF0
+
+typedef struct sh1106_image {
+    uint8_t width;
+    uint8_t height;           // multiple of 8
+    bool compressed;          // data packed by tools/asset_encode.py, else raw page-major bytes
+    const uint8_t *data;
+} sh1106_image_t;
+
+// PIO transport frame: a DMA control channel walks `desc`, reloading the data channel with
+// one run after another (setup header, then the front-buffer span) until the zero entry.
+#define SH1106_PIO_RUNS (4 * SH1106_MAX_PAGES)
+#define SH1106_PIO_HEADER 7 // D/C, count - 1, 3 setup commands, D/C, count - 1
+
+typedef struct sh1106_pio_desc {
+    uint32_t count;         // written to the data channel's TRANS_COUNT
+    const uint8_t *read;    // ... and READ_ADDR, which triggers it; NULL ends the chain
+} sh1106_pio_desc_t;
+
+typedef struct sh1106_pio_queue {
+    sh1106_pio_desc_t desc[2 * SH1106_PIO_RUNS + 1];
+    uint8_t header[SH1106_PIO_RUNS][SH1106_PIO_HEADER];
+    uint8_t runs;
+} sh1106_pio_queue_t;
 
 typedef struct sh1106 {
-    uint8_t address;
+    const sh1106_transport_t *transport;
+    uint8_t address;        // I2C
+    i2c_inst_t *i2c;
+    spi_inst_t *spi;        // SPI
+    uint8_t cs_pin;
+    uint8_t dc_pin;
+    PIO pio;                // PIO: state machine running sh1106_spi.pio
+    uint8_t sm;
+    int ctrl_chan;          // PIO: DMA channel reloading dma_chan from the descriptor queue
     uint8_t width;
     uint8_t height;
     uint8_t pages;
-    uint8_t **buffer;
-    i2c_inst_t *i2c;
+    uint8_t col_offset;                 // first RAM column of the panel (2 for 128 px, 0 for 132 px)
+    uint8_t (*front)[SH1106_ROW_BYTES]; // presented frame, the only one the flush reads
+    uint8_t (*back)[SH1106_ROW_BYTES];  // frame being drawn by the primitives
+    bool shadow_valid;                  // false until the panel RAM has been written once
+    sh1106_viewport_t viewport;         // pixels, lines, rectangles, circles and bitmaps clip to it
+    uint8_t contrast;                   // last values sent, 0x80 / on / on / normal / 0 / 0 after reset
+    bool display_on;
+    bool charge_pump;
+    bool inverse;
+    uint8_t start_line;
+    uint8_t display_offset;
+    sh1106_dirty_t dirty;   // drawn into the back buffer since the last SH1106_present
+    sh1106_dirty_t pending; // presented but not sent to the panel yet
+    uint32_t bytes_sent;    // bytes written to the bus (control + payload, no address)
+    uint32_t bytes_saved;   // full-page flush cost minus what the span/diff flush sent (draw and draw_async)
+    uint32_t transactions;  // I2C transactions (START ... STOP) issued
+    uint32_t bus_errors;    // blocking transfers NACKed or timed out, probes included
+    uint32_t glyph_blits;   // characters rasterised by SH1106_drawChar
+    bool online;            // cleared by a failed transfer or frame, set again by SH1106_reinit
+    int dma_chan;           // I2C: claimed on the first SH1106_draw_async, -1 before; PIO: at init
+    volatile uint8_t async_state;
+    bool async_pending;     // a frame was requested while another was in flight
+    sh1106_done_cb async_cb;
+    void *async_user;
+    uint16_t async_len;     // I2C: words queued in the DMA stream
+    uint32_t async_errors;  // frames dropped by a TX abort or a timeout
+    sh1106_dirty_t async_spans; // pending spans of the frame in flight, marked again if it is dropped
+    absolute_time_t async_deadline;
+    uint8_t fb[2][SH1106_MAX_PAGES][SH1106_ROW_BYTES];  // storage behind front/back
+    uint8_t shadow[SH1106_MAX_PAGES][SH1106_MAX_WIDTH]; // what the panel shows
+    union {
+        uint16_t stream[SH1106_STREAM_WORDS];           // I2C: IC_DATA_CMD words of the DMA frame
+        sh1106_pio_queue_t queue;                       // PIO: descriptors of the DMA frame
+    };
 } sh1106_t;
-void SH1106_Write_Data(sh1106_t *sh1106, uint8_t* data);
+void SH1106_Write_Data(sh1106_t *sh1106, uint8_t* data, uint8_t len);
 void SH1106_Write_CMD(sh1106_t *sh1106, uint8_t command);
+void SH1106_Write_CMDs(sh1106_t *sh1106, const uint8_t *commands, size_t n);
+extern const sh1106_transport_t sh1106_i2c_transport;
+
 void SH1106_init(sh1106_t *sh1106, i2c_inst_t *i2c, uint8_t address, uint8_t width, uint8_t height);
+void SH1106_initTransport(sh1106_t *sh1106, const sh1106_transport_t *transport, uint8_t width, uint8_t height);
+bool SH1106_probe(sh1106_t *sh1106);
+bool SH1106_reinit(sh1106_t *sh1106);
+void SH1106_busRecover(uint sda_pin, uint scl_pin);
+void SH1106_setContrast(sh1106_t *sh1106, uint8_t contrast);
+void SH1106_displayOn(sh1106_t *sh1106, bool on);
+void SH1106_setChargePump(sh1106_t *sh1106, bool on);
+void SH1106_setPower(sh1106_t *sh1106, bool on);
+void SH1106_setInverse(sh1106_t *sh1106, bool on);
+void SH1106_setStartLine(sh1106_t *sh1106, uint8_t line);
+void SH1106_setDisplayOffset(sh1106_t *sh1106, uint8_t offset);
+void SH1106_invalidate(sh1106_t *sh1106);
+void SH1106_present(sh1106_t *sh1106);
 void SH1106_draw(sh1106_t *sh1106);
+bool SH1106_draw_async(sh1106_t *sh1106, sh1106_done_cb cb, void *user);
+void SH1106_poll(sh1106_t *sh1106);
+bool SH1106_busy(sh1106_t *sh1106);
+void SH1106_draw_all(sh1106_t *const *panels, size_t n);
+void SH1106_setViewport(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void SH1106_resetViewport(sh1106_t *sh1106);
 void SH1106_drawPixel(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t color);
 void SH1106_draw_hline(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t w, uint8_t color);
+void SH1106_drawVLine(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t h, uint8_t color);
+void SH1106_fillRect(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color);
+void SH1106_clearRect(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
 void SH1106_clear(sh1106_t *sh1106);
 void SH1106_drawRectangle(sh1106_t *sh1106, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color);
-void SH1106_drawChar(sh1106_t * sh1106, char c, uint8_t x, uint8_t y, uint8_t color, const uint8_t* font);
-void SH1106_drawString(sh1106_t *sh1106, char* str, uint8_t x, uint8_t y, uint8_t color, const uint8_t* font);
+void SH1106_drawLine(sh1106_t *sh1106, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
+void SH1106_drawCircle(sh1106_t *sh1106, int16_t cx, int16_t cy, uint8_t r, uint8_t color);
+void SH1106_drawArc(sh1106_t *sh1106, int16_t cx, int16_t cy, uint8_t r, uint8_t octants, uint8_t color);
+void SH1106_drawBitmap(sh1106_t *sh1106, int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bits, uint8_t color);
+void SH1106_drawChar(sh1106_t * sh1106, char c, uint8_t x, uint8_t y, uint8_t color, const sh1106_font_t* font);
+void SH1106_drawImage(sh1106_t *sh1106, int16_t x, int16_t y, const sh1106_image_t *image, uint8_t color);
+void SH1106_drawString(sh1106_t *sh1106, char* str, uint8_t x, uint8_t y, uint8_t color, const sh1106_font_t* font);
+uint8_t SH1106_drawStringCached(sh1106_t *sh1106, sh1106_text_cache_t *cache, const char *str, uint8_t x, uint8_t y,
+                                uint8_t color, const sh1106_font_t *font);
 #endif //PI_PICO_SH1106_SH1106_I2C_H
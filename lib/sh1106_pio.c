@@ -0,0 +1,208 @@
+#include "sh1106_pio.h"
+#include "hardware/clocks.h"
+#include "sh1106_pio.pio.h"
+
+// Runs go to the state machine as D/C, count - 1 and the bytes (see sh1106_pio.pio). Like
+// the SPI transport there is no ACK: transfers cannot fail and the panel cannot be probed.
+#define RUN_MAX 256
+
+void sh1106_pio_queue_reset(sh1106_pio_queue_t *queue) {
+    queue->runs = 0;
+    queue->desc[0] = (sh1106_pio_desc_t){0, NULL};
+}
+
+// Appends setup header + data span of a run and returns the bytes it adds for the panel. One
+// slot stays free for each of the `pages_after` pages still to come: once only those are left,
+// further runs on this page widen the previous one up to their end instead.
+size_t sh1106_pio_queue_run(sh1106_pio_queue_t *queue, uint8_t page, uint8_t col, const uint8_t *data, uint8_t n,
+                            uint8_t pages_after) {
+    uint8_t r = queue->runs;
+    if(r + pages_after >= SH1106_PIO_RUNS){ //the previous run is on this page (it took no reserved slot)
+        sh1106_pio_desc_t *last = &queue->desc[2 * (r - 1) + 1];
+        uint32_t count = (uint32_t)(data + n - last->read);
+        size_t added = count - last->count;
+        last->count = count;
+        queue->header[r - 1][SH1106_PIO_HEADER - 1] = count - 1;
+        return added;
+    }
+    uint8_t *h = queue->header[r];
+    h[0] = 0;
+    h[1] = 3 - 1;
+    h[2] = SET_PAGE_ADDR | page;
+    h[3] = LOW_COL_ADDR | (col & 0x0F);
+    h[4] = HIGH_COL_ADDR | (col >> 4);
+    h[5] = 1;
+    h[6] = n - 1;
+    queue->desc[2 * r] = (sh1106_pio_desc_t){SH1106_PIO_HEADER, h};
+    queue->desc[2 * r + 1] = (sh1106_pio_desc_t){n, data};
+    queue->desc[2 * r + 2] = (sh1106_pio_desc_t){0, NULL};
+    queue->runs++;
+    return 3 + n; //D/C and count bytes never leave the state machine
+}
+
+static inline void put_byte(sh1106_t *sh1106, uint8_t b) {
+    pio_sm_put_blocking(sh1106->pio, sh1106->sm, (uint32_t)b << 24); //OUT shifts from the top
+}
+
+static void put_run(sh1106_t *sh1106, bool data, const uint8_t *bytes, size_t n) {
+    while(n > 0){
+        size_t k = n < RUN_MAX ? n : RUN_MAX;
+        put_byte(sh1106, data);
+        put_byte(sh1106, k - 1);
+        for(size_t i = 0; i < k; i++){
+            put_byte(sh1106, bytes[i]);
+        }
+        bytes += k;
+        n -= k;
+    }
+}
+
+// True once the FIFO is empty and the last byte has been shifted out: the state machine then
+// stalls at its first PULL, which sets (and keeps setting) its TXSTALL flag.
+static inline bool tx_idle(sh1106_t *sh1106) {
+    return pio_sm_is_tx_fifo_empty(sh1106->pio, sh1106->sm) &&
+           (sh1106->pio->fdebug & (1u << (PIO_FDEBUG_TXSTALL_LSB + sh1106->sm)));
+}
+
+static void tx_wait(sh1106_t *sh1106) {
+    while(!pio_sm_is_tx_fifo_empty(sh1106->pio, sh1106->sm)){
+        tight_loop_contents();
+    }
+    sh1106->pio->fdebug = 1u << (PIO_FDEBUG_TXSTALL_LSB + sh1106->sm);
+    while(!tx_idle(sh1106)){
+        tight_loop_contents();
+    }
+}
+
+static inline void cs_select(sh1106_t *sh1106) {
+    gpio_put(sh1106->cs_pin, 0);
+}
+
+static inline void cs_deselect(sh1106_t *sh1106) {
+    gpio_put(sh1106->cs_pin, 1);
+    sh1106->transactions++;
+}
+
+static bool pio_write_cmds(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    cs_select(sh1106);
+    put_run(sh1106, false, commands, n);
+    tx_wait(sh1106);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+static bool pio_write_data(sh1106_t *sh1106, const uint8_t *data, size_t n) {
+    cs_select(sh1106);
+    put_run(sh1106, true, data, n);
+    tx_wait(sh1106);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+static bool pio_write_run(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    uint8_t col = x + sh1106->col_offset;
+    const uint8_t setup[] = {SET_PAGE_ADDR | page, LOW_COL_ADDR | (col & 0x0F), HIGH_COL_ADDR | (col >> 4)};
+    cs_select(sh1106);
+    put_run(sh1106, false, setup, sizeof(setup));
+    put_run(sh1106, true, &sh1106->front[page][SH1106_ROW_HEADER + x], n);
+    tx_wait(sh1106);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += sizeof(setup) + n;
+    return true;
+}
+
+static void pio_queue_run(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    sh1106->bytes_sent += sh1106_pio_queue_run(&sh1106->queue, page, x + sh1106->col_offset,
+                                               &sh1106->front[page][SH1106_ROW_HEADER + x], n,
+                                               sh1106->pages - 1 - page);
+}
+
+// The whole frame goes out under one CS: the control channel loads the data channel with
+// each descriptor in turn and the data channel chains back to it when a run is done.
+static void pio_start(sh1106_t *sh1106) {
+    cs_select(sh1106);
+    dma_channel_set_read_addr(sh1106->ctrl_chan, sh1106->queue.desc, true);
+}
+
+// Back to the first PULL with empty FIFOs, for a frame cut off mid-run
+static void sm_reset(sh1106_t *sh1106) {
+    PIO pio = sh1106->pio;
+    uint offset = (pio->sm[sh1106->sm].execctrl & PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS) >> PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB;
+    pio_sm_clear_fifos(pio, sh1106->sm);
+    pio_sm_restart(pio, sh1106->sm);
+    pio_sm_exec(pio, sh1106->sm, pio_encode_jmp(offset));
+}
+
+static int pio_step(sh1106_t *sh1106) {
+    if(time_reached(sh1106->async_deadline)){ //only if the clock is far slower than asked for
+        dma_channel_abort(sh1106->ctrl_chan);
+        dma_channel_abort(sh1106->dma_chan);
+        sm_reset(sh1106);
+        cs_deselect(sh1106);
+        sh1106_pio_queue_reset(&sh1106->queue);
+        return -1;
+    }
+    int state = sh1106->async_state;
+    if(state == SH1106_ASYNC_BUSY){
+        const sh1106_pio_desc_t *end = &sh1106->queue.desc[2 * sh1106->queue.runs + 1]; //past the zero entry
+        if(dma_hw->ch[sh1106->ctrl_chan].read_addr != (uintptr_t)end ||
+           dma_channel_is_busy(sh1106->ctrl_chan) || dma_channel_is_busy(sh1106->dma_chan)){
+            return state;
+        }
+        sh1106->pio->fdebug = 1u << (PIO_FDEBUG_TXSTALL_LSB + sh1106->sm); //may be left over from a slow DMA
+        return SH1106_ASYNC_DRAIN;
+    }
+    if(!tx_idle(sh1106)){
+        return state;
+    }
+    cs_deselect(sh1106);
+    sh1106_pio_queue_reset(&sh1106->queue);
+    return SH1106_ASYNC_IDLE;
+}
+
+const sh1106_transport_t sh1106_pio_transport = {
+    .write_cmds = pio_write_cmds,
+    .write_data = pio_write_data,
+    .write_run = pio_write_run,
+    .probe = NULL,
+    .queue_run = pio_queue_run,
+    .start = pio_start,
+    .step = pio_step,
+    .zero_copy = true,
+};
+
+void SH1106_initPIO(sh1106_t *sh1106, PIO pio, uint8_t mosi_pin, uint8_t sck_pin, uint8_t cs_pin, uint8_t dc_pin,
+                    uint32_t baudrate, uint8_t width, uint8_t height) {
+    sh1106->pio = pio;
+    sh1106->sm = pio_claim_unused_sm(pio, true);
+    sh1106->cs_pin = cs_pin;
+    sh1106->dc_pin = dc_pin;
+    gpio_init(cs_pin);
+    gpio_set_dir(cs_pin, GPIO_OUT);
+    gpio_put(cs_pin, 1);
+    float clkdiv = (float)clock_get_hz(clk_sys) / (2.0f * baudrate); //two PIO clocks per bit
+    sh1106_spi_program_init(pio, sh1106->sm, pio_add_program(pio, &sh1106_spi_program), mosi_pin, sck_pin, dc_pin,
+                            clkdiv < 1.0f ? 1.0f : clkdiv);
+    sh1106_pio_queue_reset(&sh1106->queue);
+    SH1106_initTransport(sh1106, &sh1106_pio_transport, width, height);
+
+    sh1106->dma_chan = dma_claim_unused_channel(true);
+    sh1106->ctrl_chan = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(sh1106->dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8); //byte stores are repeated across the FIFO word
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sh1106->sm, true));
+    channel_config_set_chain_to(&cfg, sh1106->ctrl_chan);
+    dma_channel_configure(sh1106->dma_chan, &cfg, &pio->txf[sh1106->sm], NULL, 0, false);
+
+    cfg = dma_channel_get_default_config(sh1106->ctrl_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_ring(&cfg, true, 3); //writes wrap over TRANS_COUNT and READ_ADDR_TRIG
+    dma_channel_configure(sh1106->ctrl_chan, &cfg, &dma_hw->ch[sh1106->dma_chan].al3_transfer_count, NULL, 2,
+                          false);
+}
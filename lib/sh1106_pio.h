@@ -0,0 +1,20 @@
+#ifndef PI_PICO_SH1106_SH1106_PIO_H
+#define PI_PICO_SH1106_SH1106_PIO_H
+
+#include "sh1106_i2c.h"
+
+extern const sh1106_transport_t sh1106_pio_transport;
+
+// 4-wire SPI panel clocked by a PIO state machine (lib/sh1106_pio.pio) instead of an SPI
+// block. SH1106_draw_async frames go out by chained DMA straight from the framebuffer: the
+// CPU only queues descriptors, so any free pins work and neither SPI nor I2C block is used.
+// Takes one state machine and two DMA channels of `pio`.
+void SH1106_initPIO(sh1106_t *sh1106, PIO pio, uint8_t mosi_pin, uint8_t sck_pin, uint8_t cs_pin, uint8_t dc_pin,
+                    uint32_t baudrate, uint8_t width, uint8_t height);
+
+// Frame builder behind the transport, kept free of hardware access.
+void sh1106_pio_queue_reset(sh1106_pio_queue_t *queue);
+size_t sh1106_pio_queue_run(sh1106_pio_queue_t *queue, uint8_t page, uint8_t col, const uint8_t *data, uint8_t n,
+                            uint8_t pages_after);
+
+#endif //PI_PICO_SH1106_SH1106_PIO_H
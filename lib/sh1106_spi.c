@@ -0,0 +1,62 @@
+#include "sh1106_spi.h"
+
+// D/C low: command bytes, D/C high: display data. No control bytes and no ACK, so transfers
+// cannot fail and the panel cannot be probed.
+static inline void cs_select(sh1106_t *sh1106, bool data) {
+    gpio_put(sh1106->dc_pin, data);
+    gpio_put(sh1106->cs_pin, 0);
+}
+
+static inline void cs_deselect(sh1106_t *sh1106) {
+    gpio_put(sh1106->cs_pin, 1);
+    sh1106->transactions++;
+}
+
+static bool spi_write_cmds(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    cs_select(sh1106, false);
+    spi_write_blocking(sh1106->spi, commands, n);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+static bool spi_write_data(sh1106_t *sh1106, const uint8_t *data, size_t n) {
+    cs_select(sh1106, true);
+    spi_write_blocking(sh1106->spi, data, n);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+// Setup and data under one CS: D/C flips once the setup bytes have left the shifter.
+static bool spi_write_run(sh1106_t *sh1106, uint8_t page, uint8_t x, uint8_t n) {
+    uint8_t col = x + sh1106->col_offset;
+    const uint8_t setup[] = {SET_PAGE_ADDR | page, LOW_COL_ADDR | (col & 0x0F), HIGH_COL_ADDR | (col >> 4)};
+    cs_select(sh1106, false);
+    spi_write_blocking(sh1106->spi, setup, sizeof(setup)); //returns once the FIFO has drained
+    gpio_put(sh1106->dc_pin, 1);
+    spi_write_blocking(sh1106->spi, &sh1106->front[page][SH1106_ROW_HEADER + x], n);
+    cs_deselect(sh1106);
+    sh1106->bytes_sent += sizeof(setup) + n;
+    return true;
+}
+
+const sh1106_transport_t sh1106_spi_transport = {
+    .write_cmds = spi_write_cmds,
+    .write_data = spi_write_data,
+    .write_run = spi_write_run,
+    .probe = NULL,
+    .queue_run = NULL, //blocking only
+};
+
+void SH1106_initSPI(sh1106_t *sh1106, spi_inst_t *spi, uint8_t cs_pin, uint8_t dc_pin, uint8_t width, uint8_t height) {
+    sh1106->spi = spi;
+    sh1106->cs_pin = cs_pin;
+    sh1106->dc_pin = dc_pin;
+    gpio_init(cs_pin);
+    gpio_set_dir(cs_pin, GPIO_OUT);
+    gpio_put(cs_pin, 1);
+    gpio_init(dc_pin);
+    gpio_set_dir(dc_pin, GPIO_OUT);
+    SH1106_initTransport(sh1106, &sh1106_spi_transport, width, height);
+}
@@ -0,0 +1,12 @@
+#ifndef PI_PICO_SH1106_SH1106_SPI_H
+#define PI_PICO_SH1106_SH1106_SPI_H
+
+#include "sh1106_i2c.h"
+
+extern const sh1106_transport_t sh1106_spi_transport;
+
+// 4-wire SPI panel. The caller runs spi_init (mode 0, up to 10 MHz) and sets the SCK/MOSI
+// pins to GPIO_FUNC_SPI, as with i2c_init for SH1106_init; CS and D/C are driven here.
+void SH1106_initSPI(sh1106_t *sh1106, spi_inst_t *spi, uint8_t cs_pin, uint8_t dc_pin, uint8_t width, uint8_t height);
+
+#endif //PI_PICO_SH1106_SH1106_SPI_H
@@ -214,6 +214,7 @@ int main(void)
 {
     estados estado_actual = STATE_OFF;
     estados estado_prev   = N_STATES;
+    bool puerta_prev      = false;
 
     outputs_init();
     inputs_init();
@@ -226,6 +227,12 @@ int main(void)
         /* 1) inputs (1 lectura por ciclo) */
         g_in = read_inputs();
 
+        /* 1b) reposo de la pantalla: cualquier entrada la despierta */
+        bool actividad = g_in.suma30 || g_in.resta30 || g_in.start ||
+                         g_in.puerta_cerrada != puerta_prev;
+        puerta_prev = g_in.puerta_cerrada;
+        outputs_idle(estado_actual == STATE_OFF, actividad);
+
         /* 2) snapshot del tiempo */
         temporizador = timer_get();
 
@@ -243,7 +250,7 @@ int main(void)
             if (estado_actual == STATE_OFF) {
                 action_show_zero();
             } else if (estado_actual == STATE_DONE) {
-                action_show_zero();
+                action_show_done();
             }
             estado_prev = estado_actual;
         }
@@ -267,6 +274,9 @@ int main(void)
                 /* OFF y DONE ya se manejan en “al entrar” */
                 break;
         }
+
+        /* 8) servicio de salidas (envío a pantalla sin bloquear) */
+        outputs_service();
     }
 }
 
@@ -1,23 +1,66 @@
 #include "outputs.h"
 #include <stdbool.h>
+#include <string.h>
 
 #include "pico/stdlib.h"          // GPIO + tiempos + alarmas
 #include "hardware/i2c.h"         // I2C del RP2040
 
 #include "lib/sh1106_i2c.h"       // driver SH1106 (I2C)
-#include "lib/font_inconsolata.h" // fuente (bitmap caracteres)
+#include "lib/sh1106_spi.h"       // transporte SPI del mismo driver
+#include "lib/sh1106_pio.h"       // transporte SPI por PIO
+#include "fonts/font_digits_large.h" // dígitos 7 segmentos 24x48 (generados en build)
+#include "fonts/font_inconsolata.h"  // fuente 8x16 (subconjunto generado en build)
+#include "widgets.h"              // widgets en modo retenido (solo se repinta lo que cambia)
 
 /* ---------- Parámetros ajustables (según montaje) ---------- */
 #define OLED_I2C          i2c0      // bus I2C usado (i2c0 / i2c1)
 #define OLED_SDA_PIN      4         // GPIO conectado a SDA
 #define OLED_SCL_PIN      5         // GPIO conectado a SCL
-#define OLED_BAUDRATE     400000    // velocidad I2C (Hz)
+#define OLED_BAUDRATE     400000    // velocidad I2C segura (Hz): arranque y último recurso
+#define OLED_BAUD_PROBE   1000000, 800000, 400000  // se prueban de mayor a menor (Hz)
+#define OLED_PROBE_TRIES  8         // sondeos seguidos sin error para aceptar una velocidad
+#define OLED_RETRY_MIN_MS 50        // primer reintento tras perder la pantalla
+#define OLED_RETRY_MAX_MS 5000      // espera máxima entre reintentos (se dobla en cada fallo)
+#define OLED_CHECK_MS     500       // cada cuánto se comprueba que la pantalla sigue ahí y configurada
+
+#define OLED_BUS_SPI      0         // 1 = módulo SPI de 4 hilos en lugar de I2C (mismo dibujo)
+#define OLED_SPI          spi0      // bus SPI usado (spi0 / spi1)
+#define OLED_SCK_PIN      18        // GPIO de SCK
+#define OLED_MOSI_PIN     19        // GPIO de MOSI (SDA en la serigrafía de algunos módulos)
+#define OLED_CS_PIN       17        // GPIO de CS
+#define OLED_DC_PIN       20        // GPIO de D/C
+#define OLED_SPI_BAUD     10000000  // velocidad SPI (Hz), el SH1106 admite hasta 10 MHz
+#define OLED_SPI_PIO      0         // con OLED_BUS_SPI: 1 = SPI generado por PIO + DMA (deja libre el bloque SPI)
+#define OLED_PIO          pio0      // bloque PIO usado (una máquina de estados y dos canales DMA)
 
 #define OLED_ADDR         0x3C      // dirección I2C de la OLED (típica 0x3C)
 #define OLED_W            128       // ancho de pantalla (px)
 #define OLED_H            64        // alto de pantalla (px)
 
+#define OLED_CONTRAST     0x80      // contraste normal (0x00..0xFF)
+#define OLED_DIM_CONTRAST 0x08      // contraste atenuado en reposo
+#define OLED_DIM_MS       15000     // en STATE_OFF sin entradas: atenuar tras 15 s
+#define OLED_SLEEP_MS     60000     // ... y apagar el panel (pantalla + bomba de carga) tras 60 s
+
 #define BUZZER_PIN        15        // GPIO del buzzer
+
+#define TIME_X            4         // columna del primer dígito grande ("MM:SS" = 5 x 24 px)
+#define TIME_Y            8         // fila superior (múltiplo de 8: dígitos alineados a página)
+
+#define DONE_TEXT         "LISTO"   // mensaje en STATE_DONE (sus letras deben estar en SH1106_FONT_STRINGS)
+#define DONE_Y            24        // fila del mensaje
+#define MARQUEE_STEP_MS   40        // cada paso sube el mensaje 1 px (64 px = 2,56 s por vuelta)
+#define ALERT_FLASH_MS    250       // alerta de DONE: la pantalla se invierte cada 250 ms...
+#define ALERT_FLASHES     8         // ... 8 veces (2 s, lo que dura el pitido); número par = acaba normal
+
+#define BAR_X             4         // barra de tiempo restante (en PAUSE), en la última página
+#define BAR_Y             58
+#define BAR_W             120
+#define BAR_H             5
+#define BAR_FULL_S        600       // barra llena con 10 min o más
+
+#define ICON_X            120       // icono de pausa, esquina superior derecha (página 0)
+#define ICON_Y            0
 /* ---------------------------------------------------------- */
 
 #define OLED_COLOR_ON     1         // “1” = pixel encendido para este driver
@@ -25,13 +68,51 @@
 /* Objeto principal del driver (incluye buffer y config I2C) */
 static sh1106_t oled;
 
-/* Último valor de segundos dibujado (para evitar repintar sin cambios) */
-static int cached_seconds = -1;
+/* Velocidad I2C elegida por el sondeo al arrancar */
+static uint32_t oled_baud = OLED_BAUDRATE;
 
-/* Control de refresco: si no cambia nada, no redibujamos sin parar */
-static bool force_redraw = true;
+/* Recuperación de la pantalla: espera actual (0 = pantalla bien) y próximo intento */
+static uint32_t oled_retry_ms = 0;
+static absolute_time_t oled_retry_at;
+static uint32_t oled_recoveries = 0;    // veces que se ha recuperado la pantalla
+static absolute_time_t oled_check_at;   // próxima comprobación de presencia
+
+/* Widgets de la pantalla. Cada uno recuerda su valor: fijar el mismo valor no repinta nada */
+static widget_t w_time;     // "MM:SS" con los dígitos grandes
+static widget_t w_done;     // mensaje de STATE_DONE
+static widget_t w_bar;      // tiempo restante en PAUSE
+static widget_t w_pause;    // icono de pausa
+static widget_t *const screen[] = { &w_time, &w_done, &w_bar, &w_pause };
+static uint32_t oled_pixels = 0;        // píxeles repintados por los widgets (acumulado)
+
+/* Icono de pausa 8x8 (bytes por columna, bit 0 arriba) */
+static const uint8_t pause_bits[] = { 0x00, 0x7E, 0x7E, 0x00, 0x00, 0x7E, 0x7E, 0x00 };
+static const sh1106_image_t pause_icon = { 8, 8, false, pause_bits };
+
+/* Limita el refresco a ~20 Hz */
 static absolute_time_t next_refresh;
 
+/* Marquesina de "LISTO": se mueve con la línea de inicio del SH1106 (scroll por hardware),
+   así cada paso es un único comando y no se reenvía el frame */
+static bool marquee_on = false;
+static uint8_t marquee_line = 0;
+static absolute_time_t marquee_next;
+
+/* Alerta de "LISTO": parpadeo con el modo inverso del SH1106 (un comando por cambio,
+   sin redibujar ni reenviar el frame) */
+static uint8_t alert_left = 0;          // inversiones que quedan
+static absolute_time_t alert_next;
+
+/* Reposo de la pantalla: DESPIERTA -> ATENUADA -> APAGADA (ver outputs_idle) */
+typedef enum {
+    OLED_AWAKE,
+    OLED_DIM,
+    OLED_SLEEP
+} oled_power;
+
+static oled_power oled_state = OLED_AWAKE;
+static absolute_time_t idle_since;      // última entrada (o salida de STATE_OFF)
+
 /* -------------------- BUZZER (no bloqueante) -------------------- */
 /*
    El FSM en STATE_DONE puede NO llamar outputs_update().
@@ -61,8 +142,43 @@ static int64_t buzzer_alarm_cb(alarm_id_t id, void *user_data) {
 
 /* -------------------- OLED (init y dibujo) -------------------- */
 
+#if !OLED_BUS_SPI
+/* Busca la velocidad I2C más alta a la que la pantalla responde sin errores.
+   Cada velocidad debe pasar OLED_PROBE_TRIES sondeos seguidos (NOP con ACK + lectura
+   del byte de estado); al primer fallo se baja a la siguiente. Si ninguna pasa se
+   queda en OLED_BAUDRATE. */
+static void oled_probe_baud(void) {
+    static const uint32_t steps[] = { OLED_BAUD_PROBE };
+
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        uint32_t actual = i2c_set_baudrate(OLED_I2C, steps[i]);
+        int ok = 0;
+        while (ok < OLED_PROBE_TRIES && SH1106_probe(&oled)) ok++;
+        if (ok == OLED_PROBE_TRIES) {
+            oled_baud = actual;
+            return;
+        }
+    }
+    oled_baud = i2c_set_baudrate(OLED_I2C, OLED_BAUDRATE);
+}
+#endif
+
 /* Inicializa el bus I2C y la OLED SH1106 */
 static void oled_init_hw(void) {
+#if OLED_BUS_SPI
+    // SPI: sin ACK ni lectura de estado, así que no hay sondeo de velocidad
+#if OLED_SPI_PIO
+    // El PIO genera SCK/MOSI/D/C y el DMA manda los frames desde el framebuffer
+    SH1106_initPIO(&oled, OLED_PIO, OLED_MOSI_PIN, OLED_SCK_PIN, OLED_CS_PIN, OLED_DC_PIN,
+                   OLED_SPI_BAUD, OLED_W, OLED_H);
+#else
+    spi_init(OLED_SPI, OLED_SPI_BAUD);
+    gpio_set_function(OLED_SCK_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(OLED_MOSI_PIN, GPIO_FUNC_SPI);
+    SH1106_initSPI(&oled, OLED_SPI, OLED_CS_PIN, OLED_DC_PIN, OLED_W, OLED_H);
+#endif
+    SH1106_setContrast(&oled, OLED_CONTRAST);
+#else
     i2c_init(OLED_I2C, OLED_BAUDRATE);                 // arranca I2C
 
     gpio_set_function(OLED_SDA_PIN, GPIO_FUNC_I2C);    // SDA como I2C
@@ -72,14 +188,112 @@ static void oled_init_hw(void) {
     gpio_pull_up(OLED_SDA_PIN);
     gpio_pull_up(OLED_SCL_PIN);
 
+    // Máxima corriente de bajada: flancos más limpios a 1 MHz (fast-mode plus)
+    gpio_set_drive_strength(OLED_SDA_PIN, GPIO_DRIVE_STRENGTH_12MA);
+    gpio_set_drive_strength(OLED_SCL_PIN, GPIO_DRIVE_STRENGTH_12MA);
+
     // Inicializa el driver y limpia pantalla
     SH1106_init(&oled, OLED_I2C, OLED_ADDR, OLED_W, OLED_H);
+    SH1106_setContrast(&oled, OLED_CONTRAST);
+    oled_probe_baud();
+#endif
     SH1106_clear(&oled);
+    SH1106_present(&oled);
     SH1106_draw(&oled);
 }
 
-/* Convierte segundos a "MM:SS" y lo dibuja en la pantalla */
-static void draw_time_mmss(int seconds) {
+/* Crea los widgets (ocultos: la pantalla empieza en negro) */
+static void screen_init(void) {
+    // Dígitos alineados a página: cada columna es un byte entero por página
+    widget_numero(&w_time, TIME_X, TIME_Y, 5, &font_digits_large);
+    int x = (OLED_W - (int)strlen(DONE_TEXT) * font_inconsolata.width) / 2;
+    widget_texto(&w_done, x, DONE_Y, strlen(DONE_TEXT), &font_inconsolata);
+    widget_set_texto(&w_done, DONE_TEXT);
+    widget_barra(&w_bar, BAR_X, BAR_Y, BAR_W, BAR_H);
+    widget_icono(&w_pause, ICON_X, ICON_Y, &pause_icon);
+}
+
+/* Envía el frame presentado. Con el panel apagado no se envía nada: queda pendiente
+   en el driver y sale al despertar */
+static void oled_send(void) {
+    if (oled_state == OLED_SLEEP) return;
+    SH1106_draw_async(&oled, NULL, NULL);
+}
+
+/* Repinta los widgets que han cambiado y, si alguno lo ha hecho, publica y envía el frame.
+   Solo llegan al flush las cajas de esos widgets (el driver marca lo que se dibuja). */
+static void screen_render(void) {
+    uint32_t pixels = widgets_render(&oled, screen, count_of(screen));
+    if (pixels == 0) return;
+    oled_pixels += pixels;
+
+    // Se dibuja en el buffer trasero; present lo publica entero de golpe,
+    // así nunca se envía un frame a medio pintar
+    SH1106_present(&oled);
+
+    // Envío por DMA: no bloquea el bucle de la FSM. Si hay un frame en vuelo,
+    // el driver deja este pendiente y lo manda al terminar el anterior.
+    oled_send();
+}
+
+/* Vuelve a contraste normal (y enciende el panel si estaba apagado) */
+static void oled_wake(void) {
+    SH1106_setContrast(&oled, OLED_CONTRAST);
+    if (oled_state == OLED_SLEEP) {
+        // Un reset del panel mientras dormía no se nota en el sondeo (los dos dicen
+        // "pantalla apagada"): al encender se repite la configuración y el frame entero
+        SH1106_setPower(&oled, true);
+        SH1106_reinit(&oled);
+    }
+    oled_state = OLED_AWAKE;
+    SH1106_draw_async(&oled, NULL, NULL);   // lo dibujado mientras estaba apagado
+}
+
+/*
+   Pantalla caída (el driver la marca offline tras un fallo o timeout del bus y deja de
+   escribir). Se reintenta con espera exponencial: liberar el bus (9 pulsos de SCL + STOP),
+   reiniciar el I2C y reenviar configuración y frame completo (si no hay ACK, se sigue esperando).
+   Cada intento cuesta como mucho un par de timeouts, así el bucle de la FSM no se para.
+*/
+static void oled_recover(void) {
+    if (oled_retry_ms == 0) {                       // fallo recién detectado
+        oled_retry_ms = OLED_RETRY_MIN_MS;
+        oled_retry_at = make_timeout_time_ms(oled_retry_ms);
+        return;
+    }
+    if (absolute_time_diff_us(get_absolute_time(), oled_retry_at) > 0) return;
+
+#if !OLED_BUS_SPI
+    SH1106_busRecover(OLED_SDA_PIN, OLED_SCL_PIN);
+    i2c_init(OLED_I2C, oled_baud);
+#endif
+    if (SH1106_reinit(&oled)) {                     // falla si el panel no da ACK
+        oled_retry_ms = 0;
+        oled_recoveries++;
+        oled_send();                                // frame completo (reinit lo invalida)
+        return;
+    }
+
+    oled_retry_ms *= 2;
+    if (oled_retry_ms > OLED_RETRY_MAX_MS) oled_retry_ms = OLED_RETRY_MAX_MS;
+    oled_retry_at = make_timeout_time_ms(oled_retry_ms);
+}
+
+/* Para la marquesina y deja la pantalla en su posición normal */
+static void marquee_stop(void) {
+    if (!marquee_on) return;
+    marquee_on = false;
+    SH1106_setStartLine(&oled, 0);
+}
+
+/* Para el parpadeo y deja la pantalla en modo normal */
+static void alert_stop(void) {
+    alert_left = 0;
+    if (oled.inverse) SH1106_setInverse(&oled, false);
+}
+
+/* Convierte segundos a "MM:SS" y lo pone en el widget del tiempo */
+static void set_time_mmss(int seconds) {
     if (seconds < 0) seconds = 0;      // por seguridad, no negativos
 
     int m = seconds / 60;              // minutos
@@ -96,10 +310,10 @@ static void draw_time_mmss(int seconds) {
     buf[4] = '0' + (s % 10);
     buf[5] = '\0';
 
-    // Pantalla: SOLO números y ":"
-    SH1106_clear(&oled);
-    SH1106_drawString(&oled, (char*)buf, 0, 0, OLED_COLOR_ON, inconsolata);
-    SH1106_draw(&oled);
+    // Solo números y ":" en grande. Cada dígito pinta también su fondo, así que
+    // solo se repintan (y solo se envían) los dígitos que han cambiado
+    widget_set_texto(&w_time, buf);
+    widget_set_visible(&w_time, true);
 }
 /* ------------------------------------------------------------- */
 
@@ -114,11 +328,14 @@ void outputs_init(void) {
 
     // OLED
     oled_init_hw();
+    screen_init();
 
     // Estado inicial
-    cached_seconds = -1;
-    force_redraw = true;
     next_refresh = make_timeout_time_ms(0); // refresco inmediato al arrancar
+    oled_state = OLED_AWAKE;
+    idle_since = get_absolute_time();
+    oled_retry_ms = 0;
+    oled_check_at = make_timeout_time_ms(OLED_CHECK_MS);
 }
 
 /*
@@ -128,44 +345,162 @@ void outputs_init(void) {
    Recibe un snapshot del temporizador (timer t).
 */
 void outputs_update(timer t) {
-    // Limito refresco aprox a 20 Hz si no hay cambios
-    if (!force_redraw && absolute_time_diff_us(get_absolute_time(), next_refresh) > 0) {
+    // Limito refresco aprox a 20 Hz
+    if (absolute_time_diff_us(get_absolute_time(), next_refresh) > 0) {
         return;
     }
     next_refresh = make_timeout_time_ms(50);
 
-    // Si cambia el tiempo, marcamos redibujo
-    if (t.segundos != cached_seconds) {
-        cached_seconds = t.segundos;
-        force_redraw = true;
+    // Se fijan los valores; solo se repintan los widgets cuyo valor ha cambiado
+    int restante = t.segundos < 0 ? 0 : t.segundos;
+    set_time_mmss(restante);
+    widget_set_valor(&w_bar, restante > BAR_FULL_S ? BAR_FULL_S : restante, BAR_FULL_S);
+    widget_set_visible(&w_bar, true);
+    widget_set_visible(&w_pause, true);
+    widget_set_visible(&w_done, false);
+    screen_render();
+}
+
+/* Se llama desde el main en STATE_OFF */
+void outputs_off(void) {
+    marquee_stop();
+    alert_stop();
+
+    // Oculta todo (al volver a encender se redibuja entero) y apaga el panel: no hace
+    // falta enviar un frame negro, el borrado sale al despertar (outputs_idle)
+    for (size_t i = 0; i < count_of(screen); i++) {
+        widget_set_visible(screen[i], false);
+    }
+    oled_pixels += widgets_render(&oled, screen, count_of(screen));
+    SH1106_present(&oled);
+    if (oled_state != OLED_SLEEP) {
+        SH1106_setPower(&oled, false);
+        oled_state = OLED_SLEEP;
+    }
+}
+
+/*
+   Política de reposo (1 vez por vuelta del bucle):
+   - en_off: la FSM está en STATE_OFF
+   - actividad: hubo alguna entrada en esta vuelta (botón o cambio de puerta)
+   Fuera de OFF o con cualquier entrada la pantalla despierta al momento; en OFF sin
+   entradas se atenúa tras OLED_DIM_MS y se apaga tras OLED_SLEEP_MS.
+*/
+void outputs_idle(bool en_off, bool actividad) {
+    absolute_time_t now = get_absolute_time();
+
+    if (!en_off || actividad) {
+        idle_since = now;
+        if (oled_state != OLED_AWAKE) oled_wake();
+        return;
     }
 
-    // Si no hay nada que hacer, salimos
-    if (!force_redraw) return;
-    force_redraw = false;
+    // Los cambios esperan a que no haya un frame en vuelo (así nunca bloquean)
+    if (SH1106_busy(&oled)) return;
 
-    // Dibujar tiempo
-    draw_time_mmss(cached_seconds);
+    int64_t idle_ms = absolute_time_diff_us(idle_since, now) / 1000;
+    if (oled_state == OLED_AWAKE && idle_ms >= OLED_DIM_MS) {
+        SH1106_setContrast(&oled, OLED_DIM_CONTRAST);
+        oled_state = OLED_DIM;
+    }
+    if (oled_state == OLED_DIM && idle_ms >= OLED_SLEEP_MS) {
+        SH1106_setPower(&oled, false);
+        oled_state = OLED_SLEEP;
+    }
 }
 
-/* Se llama desde el main en STATE_OFF */
-void outputs_off(void) {
-    // Reinicio cache para que al volver a encender se redibuje sí o sí
-    cached_seconds = -1;
-    force_redraw = false;
+/* Velocidad I2C en uso (Hz), errores de bus de la pantalla (sondeo y frames DMA incluidos)
+   y recuperaciones tras una caída */
+uint32_t outputs_oled_baud(void) {
+    return oled_baud;
+}
 
-    // Limpia OLED
-    SH1106_clear(&oled);
-    SH1106_draw(&oled);
+uint32_t outputs_oled_errors(void) {
+    return oled.bus_errors + oled.async_errors;
+}
+
+uint32_t outputs_oled_recoveries(void) {
+    return oled_recoveries;
+}
+
+/* Píxeles repintados por los widgets desde el arranque (coste de dibujo de la interfaz) */
+uint32_t outputs_oled_pixels(void) {
+    return oled_pixels;
+}
+
+/* Se llama en cada vuelta del bucle principal */
+void outputs_service(void) {
+    // Avanza el envío por DMA (y lanza el frame pendiente si lo hay)
+    SH1106_poll(&oled);
+
+    // Pantalla caída: solo se intenta recuperar, sin escribir nada más
+    if (!oled.online) {
+        oled_recover();
+        return;
+    }
+
+    // Comprobación periódica (NOP con ACK + byte de estado). Si el módulo se ha
+    // reconectado o ha sufrido un brown-out vuelve en reset (pantalla apagada, sin
+    // remap): se repite la configuración y se reenvía el frame completo. Si no
+    // responde, reinit falla, el driver la marca offline y entra oled_recover.
+    // Con el panel apagado no se comprueba (bus en silencio): oled_wake ya repite la
+    // configuración al encender.
+    if (oled_state != OLED_SLEEP && !SH1106_busy(&oled) &&
+        absolute_time_diff_us(get_absolute_time(), oled_check_at) <= 0) {
+        oled_check_at = make_timeout_time_ms(OLED_CHECK_MS);
+        if (!SH1106_probe(&oled) && SH1106_reinit(&oled)) {
+            oled_recoveries++;
+            oled_send();
+        }
+    }
+
+    // Paso de la marquesina: solo con el bus libre, para no bloquear esperando al DMA
+    if (marquee_on && !SH1106_busy(&oled) &&
+        absolute_time_diff_us(get_absolute_time(), marquee_next) <= 0) {
+        marquee_next = make_timeout_time_ms(MARQUEE_STEP_MS);
+        marquee_line = (marquee_line + 1) % OLED_H;
+        SH1106_setStartLine(&oled, marquee_line);
+    }
+
+    // Parpadeo de la alerta, con la misma condición
+    if (alert_left > 0 && !SH1106_busy(&oled) &&
+        absolute_time_diff_us(get_absolute_time(), alert_next) <= 0) {
+        alert_next = make_timeout_time_ms(ALERT_FLASH_MS);
+        alert_left--;
+        SH1106_setInverse(&oled, !oled.inverse);
+    }
 }
 
 /* ===================== ACTIONS (FSM) ===================== */
 
 /* Mostrar 00:00 (normalmente en DONE) */
 void action_show_zero(void) {
-    cached_seconds = 0;
-    force_redraw = true;
-    draw_time_mmss(0);
+    marquee_stop();
+    alert_stop();
+    set_time_mmss(0);
+    widget_set_visible(&w_done, false);
+    widget_set_visible(&w_bar, false);
+    widget_set_visible(&w_pause, false);
+    screen_render();
+}
+
+/* Mensaje "LISTO" en movimiento (al entrar en DONE) */
+void action_show_done(void) {
+    // El tiempo se oculta (al salir se redibuja entero) y aparece el mensaje
+    widget_set_visible(&w_time, false);
+    widget_set_visible(&w_bar, false);
+    widget_set_visible(&w_pause, false);
+    widget_set_visible(&w_done, true);
+    screen_render();
+
+    // La marquesina arranca desde la posición normal; outputs_service la va moviendo
+    marquee_on = true;
+    marquee_line = 0;
+    marquee_next = make_timeout_time_ms(MARQUEE_STEP_MS);
+
+    // Y parpadea mientras suena el pitido (el primer cambio sale en el siguiente servicio)
+    alert_left = ALERT_FLASHES;
+    alert_next = get_absolute_time();
 }
 
 /* Pitido de 2000 ms sin bloquear (no depende de outputs_update) */
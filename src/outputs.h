@@ -1,6 +1,9 @@
 #ifndef OUTPUTS_H
 #define OUTPUTS_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "timer.h"
 
 /* Init del módulo (1 vez) */
@@ -9,11 +12,27 @@ void outputs_init(void);
 /* Refresco con snapshot del temporizador */
 void outputs_update(timer t);
 
-/* Apagar pantalla */
+/* Apagar pantalla (panel en reposo hasta la siguiente actividad) */
 void outputs_off(void);
 
+/* Reposo: atenúa y apaga la pantalla en STATE_OFF sin entradas; despierta con cualquier entrada */
+void outputs_idle(bool en_off, bool actividad);
+
+/* Servicio periódico (1 vez por vuelta del bucle): avanza el envío a la pantalla */
+void outputs_service(void);
+
+/* Diagnóstico del bus de la pantalla: velocidad elegida al arrancar, errores acumulados
+   y recuperaciones tras una caída */
+uint32_t outputs_oled_baud(void);
+uint32_t outputs_oled_errors(void);
+uint32_t outputs_oled_recoveries(void);
+
+/* Píxeles repintados por los widgets desde el arranque */
+uint32_t outputs_oled_pixels(void);
+
 /* Acciones que llama la FSM */
 void action_show_zero(void);
+void action_show_done(void);   /* "LISTO" con scroll por hardware y parpadeo en inverso (en outputs_service) */
 void action_buzzer_on(void);
 void action_buzzer_off(void);
 void action_reset_all(void);  
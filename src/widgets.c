@@ -0,0 +1,126 @@
+#include "widgets.h"
+#include <string.h>
+
+/*
+    Widgets de la pantalla: ver widgets.h.
+
+    Todo se dibuja en el buffer trasero del driver. Los primitivos del driver marcan
+    como sucias solo las columnas que tocan, así que lo que llega al flush (y al bus)
+    son exactamente las cajas de los widgets repintados.
+*/
+
+static void widget_base(widget_t *w, widget_tipo tipo, uint8_t x, uint8_t y, uint8_t ancho, uint8_t alto) {
+    memset(w, 0, sizeof(*w));
+    w->tipo = tipo;
+    w->x = x;
+    w->y = y;
+    w->w = ancho;
+    w->h = alto;
+}
+
+void widget_texto(widget_t *w, uint8_t x, uint8_t y, uint8_t caracteres, const sh1106_font_t *fuente) {
+    if (caracteres > WIDGET_MAX_TEXTO) caracteres = WIDGET_MAX_TEXTO;
+    widget_base(w, WIDGET_TEXTO, x, y, caracteres * fuente->width, fuente->height);
+    w->fuente = fuente;
+}
+
+void widget_numero(widget_t *w, uint8_t x, uint8_t y, uint8_t caracteres, const sh1106_font_t *fuente) {
+    widget_texto(w, x, y, caracteres, fuente);
+    w->tipo = WIDGET_NUMERO;
+}
+
+void widget_barra(widget_t *w, uint8_t x, uint8_t y, uint8_t ancho, uint8_t alto) {
+    widget_base(w, WIDGET_BARRA, x, y, ancho, alto);
+    w->maximo = 1;
+}
+
+void widget_icono(widget_t *w, uint8_t x, uint8_t y, const sh1106_image_t *icono) {
+    widget_base(w, WIDGET_ICONO, x, y, icono->width, icono->height);
+    w->icono = icono;
+}
+
+void widget_set_texto(widget_t *w, const char *texto) {
+    char nuevo[WIDGET_MAX_TEXTO + 1];
+    size_t max = w->w / w->fuente->width;     // lo que no cabe en la caja no se dibuja
+    strncpy(nuevo, texto, max);
+    nuevo[max] = '\0';
+    if (strcmp(nuevo, w->texto) == 0) return;
+    memcpy(w->texto, nuevo, sizeof(nuevo));
+    w->sucio = true;
+}
+
+void widget_set_valor(widget_t *w, uint16_t valor, uint16_t maximo) {
+    if (maximo == 0) maximo = 1;
+    if (valor > maximo) valor = maximo;
+    if (w->valor == valor && w->maximo == maximo) return;
+    w->valor = valor;
+    w->maximo = maximo;
+    w->sucio = true;
+}
+
+void widget_set_visible(widget_t *w, bool visible) {
+    if (w->visible == visible) return;
+    w->visible = visible;
+    w->sucio = true;
+}
+
+/* NUMERO: el driver compara cada celda con la que hay en pantalla y solo repinta
+   (y marca para enviar) las que cambian */
+static uint32_t render_numero(sh1106_t *oled, widget_t *w) {
+    uint8_t celdas = SH1106_drawStringCached(oled, &w->mostrado, w->texto, w->x, w->y, 1, w->fuente);
+    return (uint32_t)celdas * w->fuente->width * w->h;
+}
+
+/* BARRA: marco de 1 px y relleno proporcional con 1 px de margen */
+static void render_barra(sh1106_t *oled, const widget_t *w) {
+    uint8_t interior = w->w - 4;
+    uint8_t lleno = (uint32_t)interior * w->valor / w->maximo;
+
+    SH1106_draw_hline(oled, w->x, w->y, w->w, 1);
+    SH1106_draw_hline(oled, w->x, w->y + w->h - 1, w->w, 1);
+    SH1106_drawVLine(oled, w->x, w->y, w->h, 1);
+    SH1106_drawVLine(oled, w->x + w->w - 1, w->y, w->h, 1);
+    SH1106_clearRect(oled, w->x + 1, w->y + 1, w->w - 2, w->h - 2);
+    SH1106_fillRect(oled, w->x + 2, w->y + 2, lleno, w->h - 4, 1);
+}
+
+static uint32_t render(sh1106_t *oled, widget_t *w) {
+    uint32_t caja = (uint32_t)w->w * w->h;
+
+    if (!w->visible) {
+        SH1106_clearRect(oled, w->x, w->y, w->w, w->h);
+        memset(&w->mostrado, 0, sizeof(w->mostrado));
+        return caja;
+    }
+    switch (w->tipo) {
+        case WIDGET_NUMERO:
+            return render_numero(oled, w);
+        case WIDGET_TEXTO:
+            SH1106_clearRect(oled, w->x, w->y, w->w, w->h);
+            SH1106_drawString(oled, w->texto, w->x, w->y, 1, w->fuente);
+            break;
+        case WIDGET_BARRA:
+            render_barra(oled, w);
+            break;
+        case WIDGET_ICONO:
+            SH1106_clearRect(oled, w->x, w->y, w->w, w->h);
+            SH1106_drawImage(oled, w->x, w->y, w->icono, 1);
+            break;
+    }
+    return caja;
+}
+
+uint32_t widgets_render(sh1106_t *oled, widget_t *const *lista, size_t n) {
+    uint32_t pixeles = 0;
+
+    // Dos pasadas: lo que desaparece se borra antes de pintar lo que aparece encima
+    for (int pasada = 0; pasada < 2; pasada++) {
+        for (size_t i = 0; i < n; i++) {
+            widget_t *w = lista[i];
+            if (!w->sucio || w->visible != (pasada == 1)) continue;
+            w->sucio = false;
+            pixeles += render(oled, w);
+        }
+    }
+    return pixeles;
+}
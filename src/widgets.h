@@ -0,0 +1,59 @@
+/*
+    Widgets de la pantalla (modo retenido).
+
+    Cada widget guarda su caja en pantalla, su valor y si ha cambiado desde el último
+    repintado. widgets_render solo repinta los que han cambiado, y solo dentro de su caja:
+    el coste de refrescar depende de lo que cambia, no del tamaño de la pantalla.
+    Los widgets visibles a la vez no deben solaparse.
+
+      - TEXTO:  cadena con una fuente (se repinta entera al cambiar)
+      - NUMERO: cadena con una fuente de celdas fijas (solo se repintan las celdas que cambian)
+      - BARRA:  barra de progreso valor / máximo con marco
+      - ICONO:  imagen 1bpp (sh1106_image_t)
+*/
+#ifndef WIDGETS_H
+#define WIDGETS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/sh1106_i2c.h"
+
+#define WIDGET_MAX_TEXTO 8          // caracteres máximos de TEXTO / NUMERO
+
+typedef enum {
+    WIDGET_TEXTO,
+    WIDGET_NUMERO,
+    WIDGET_BARRA,
+    WIDGET_ICONO
+} widget_tipo;
+
+typedef struct {
+    widget_tipo tipo;
+    uint8_t x, y, w, h;             // caja que ocupa (se borra al ocultarlo o repintarlo)
+    bool visible;
+    bool sucio;                     // valor o visibilidad cambiados desde el último repintado
+    const sh1106_font_t *fuente;    // TEXTO / NUMERO
+    char texto[WIDGET_MAX_TEXTO + 1];
+    sh1106_text_cache_t mostrado;   // NUMERO: lo que hay en pantalla (celdas)
+    uint16_t valor, maximo;         // BARRA
+    const sh1106_image_t *icono;    // ICONO
+} widget_t;
+
+/* Creación: la caja se calcula a partir de la fuente / imagen. Empiezan ocultos. */
+void widget_texto(widget_t *w, uint8_t x, uint8_t y, uint8_t caracteres, const sh1106_font_t *fuente);
+void widget_numero(widget_t *w, uint8_t x, uint8_t y, uint8_t caracteres, const sh1106_font_t *fuente);
+void widget_barra(widget_t *w, uint8_t x, uint8_t y, uint8_t ancho, uint8_t alto);
+void widget_icono(widget_t *w, uint8_t x, uint8_t y, const sh1106_image_t *icono);
+
+/* Cambios de valor: solo marcan el widget si el valor es distinto del que tiene */
+void widget_set_texto(widget_t *w, const char *texto);
+void widget_set_valor(widget_t *w, uint16_t valor, uint16_t maximo);
+void widget_set_visible(widget_t *w, bool visible);
+
+/* Repinta en el buffer trasero los widgets marcados (primero borra los que se ocultan,
+   por si se solapan con los que aparecen). Devuelve los píxeles repintados: 0 = nada
+   cambió y no hace falta presentar ni enviar nada. */
+uint32_t widgets_render(sh1106_t *oled, widget_t *const *lista, size_t n);
+
+#endif
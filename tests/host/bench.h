@@ -0,0 +1,14 @@
+// Wall-clock timing for the bench_* programs. Host numbers only compare paths with each
+// other; on the RP2040 the ratios hold roughly, the absolute times do not.
+#ifndef SH1106_HOST_BENCH_H
+#define SH1106_HOST_BENCH_H
+
+#include <time.h>
+
+static inline double bench_now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,80 @@
+// A 10-minute countdown, one "MM:SS" per second from 10:00 to 00:00: glyph blits and bus
+// bytes with drawString redrawing every cell vs drawStringCached redrawing the cells that
+// changed, in both fonts. The two must show the same frame on every tick. Bytes per tick
+// are the bus time the countdown costs each second.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_digits_large.h"
+#include "fonts/font_inconsolata.h"
+
+#define TICKS 601
+
+// Bus bytes per tick the countdown may cost, checked so a regression fails here. The 8x16
+// text costs 29.4 B/tick. The big digits were meant not to exceed that, but a 24x48 digit
+// spans six pages of ~20 columns: one vertical segment turning on or off is already ~22 B,
+// and no page-aligned 7-segment layout of that size models below ~55 B/tick (a 16x24 one
+// for the seconds alone still gives ~33). Their budget is what the page-aligned layout of
+// tools/segment_font.py reaches, 70.9 B/tick, plus some margin.
+#define BUDGET_INCONSOLATA 30
+#define BUDGET_DIGITS      72
+
+static sh1106_t full, cached;
+
+static void mmss(char *buf, int seconds) {
+    buf[0] = '0' + seconds / 600;
+    buf[1] = '0' + seconds / 60 % 10;
+    buf[2] = ':';
+    buf[3] = '0' + seconds % 60 / 10;
+    buf[4] = '0' + seconds % 10;
+    buf[5] = '\0';
+}
+
+static void run(const sh1106_font_t *font, const char *name, uint32_t budget) {
+    sh1106_text_cache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    SH1106_clear(&full);
+    SH1106_clear(&cached);
+    uint32_t blits[2] = {full.glyph_blits, cached.glyph_blits};
+    uint32_t sent[2] = {full.bytes_sent, cached.bytes_sent};
+    bool same = true;
+    for(int s = TICKS - 1; s >= 0; s--){
+        char text[6];
+        mmss(text, s);
+        SH1106_drawString(&full, text, 4, 8, 1, font);
+        SH1106_drawStringCached(&cached, &cache, text, 4, 8, 1, font);
+        SH1106_present(&full);
+        SH1106_present(&cached);
+        SH1106_draw(&full);
+        SH1106_draw(&cached);
+        for(int page = 0; page < 8; page++){
+            same &= memcmp(&full.front[page][SH1106_ROW_HEADER], &cached.front[page][SH1106_ROW_HEADER], 128) == 0;
+        }
+    }
+    blits[0] = full.glyph_blits - blits[0];
+    blits[1] = cached.glyph_blits - blits[1];
+    sent[0] = full.bytes_sent - sent[0];
+    sent[1] = cached.bytes_sent - sent[1];
+    CHECK(same);
+    CHECK_EQ(blits[0], 5 * TICKS);
+    CHECK(blits[1] < 2 * TICKS);
+    printf("%s: drawString %u blits (%.2f/tick), %u B; cached %u blits (%.2f/tick), %u B (%.1f B/tick)\n", name,
+           blits[0], (double)blits[0] / TICKS, sent[0], blits[1], (double)blits[1] / TICKS, sent[1],
+           (double)sent[1] / TICKS);
+    CHECK(sent[1] <= budget * TICKS);
+}
+
+int main(void) {
+    sim_panel_t *a = sim_i2c_attach(i2c0, 0x3C);
+    sim_panel_t *b = sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c0, 400000);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&full, i2c0, 0x3C, 128, 64);
+    SH1106_init(&cached, i2c1, 0x3C, 128, 64);
+    run(&font_inconsolata, "inconsolata 8x16", BUDGET_INCONSOLATA);
+    run(&font_digits_large, "digits 24x48", BUDGET_DIGITS);
+    CHECK(sim_panel_shows(a, &full));
+    CHECK(sim_panel_shows(b, &cached));
+    return check_result();
+}
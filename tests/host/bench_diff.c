@@ -0,0 +1,95 @@
+// The shadow diff: host time of a flush with and without it against the bus time it saves
+// at 400 kHz (the host time includes handing the bytes to the sim bus, not decoding them),
+// for the countdown's redraws (clear and draw the same "MM:SS", one digit changing) and a
+// full-screen change where it saves nothing. "Without diff" sends the same pending spans
+// whole, as if the shadow did not exist.
+#include <string.h>
+
+#include "bench.h"
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+#define REPS 20000
+
+static sh1106_t oled;
+static sh1106_dirty_t spans;
+static uint8_t shadow[SH1106_MAX_PAGES][SH1106_MAX_WIDTH];
+
+static void scene_same(void) {
+    SH1106_clear(&oled);
+    SH1106_drawString(&oled, "12:34", 24, 24, 1, &font_inconsolata);
+}
+
+static void scene_digit(void) {
+    SH1106_clear(&oled);
+    SH1106_drawString(&oled, "12:35", 24, 24, 1, &font_inconsolata);
+}
+
+static void scene_full(void) {
+    SH1106_fillRect(&oled, 0, 0, 128, 64, 1);
+    SH1106_drawString(&oled, "12:35", 24, 24, 0, &font_inconsolata);
+}
+
+// Flush state before the frame, put back before every timed flush
+static void restore(bool diff) {
+    oled.pending = spans;
+    memcpy(oled.shadow, shadow, sizeof(shadow));
+    oled.shadow_valid = diff;
+}
+
+static double flush_ns(bool diff) {
+    double t0 = bench_now_ns();
+    for(int r = 0; r < REPS; r++){
+        restore(diff);
+        SH1106_draw(&oled);
+    }
+    double t1 = bench_now_ns();
+    for(int r = 0; r < REPS; r++){
+        restore(diff);
+    }
+    return ((t1 - t0) - (bench_now_ns() - t1)) / REPS;
+}
+
+static void run(const char *name, void (*scene)(void)) {
+    scene();
+    SH1106_present(&oled);
+    spans = oled.pending;
+    memcpy(shadow, oled.shadow, sizeof(shadow));
+
+    uint64_t us[2];
+    uint32_t bytes[2];
+    for(int diff = 0; diff < 2; diff++){
+        restore(diff);
+        uint64_t busy = sim_i2c_busy_us;
+        uint32_t sent = oled.bytes_sent;
+        SH1106_draw(&oled);
+        us[diff] = sim_i2c_busy_us - busy;
+        bytes[diff] = oled.bytes_sent - sent;
+    }
+    sim_i2c_unseen = true;
+    double ns[2] = {flush_ns(false), flush_ns(true)};
+    sim_i2c_unseen = false;
+    restore(true);
+    SH1106_draw(&oled);
+    printf("%-22s without diff %4u B, %5llu us bus, %4.0f ns host; with diff %4u B, %5llu us bus, %4.0f ns host\n",
+           name, bytes[0], (unsigned long long)us[0], ns[0], bytes[1], (unsigned long long)us[1], ns[1]);
+    CHECK(bytes[1] <= bytes[0]);
+}
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+    scene_same();
+    SH1106_present(&oled);
+    SH1106_draw(&oled);
+
+    run("clear + same text:", scene_same);
+    CHECK(sim_panel_shows(panel, &oled));
+    run("one digit changes:", scene_digit);
+    CHECK(sim_panel_shows(panel, &oled));
+    run("whole screen changes:", scene_full);
+    CHECK(sim_panel_shows(panel, &oled));
+    return check_result();
+}
@@ -0,0 +1,94 @@
+// Page-mask fills (fillRect, clearRect, draw_hline, drawVLine) against one SH1106_drawPixel
+// per pixel: pixel-exact over random rectangles on a noisy background, clipped ones
+// included, then host time for the shapes the UI draws.
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "check.h"
+#include "sim.h"
+
+#define REPS 20000
+
+static sh1106_t masked, reference;
+
+static void per_pixel(sh1106_t *sh1106, int x, int y, int w, int h, uint8_t color) {
+    for(int j = y; j < y + h; j++){
+        for(int i = x; i < x + w; i++){
+            if(i < 256 && j < 256){ //drawPixel takes uint8_t
+                SH1106_drawPixel(sh1106, i, j, color);
+            }
+        }
+    }
+}
+
+static void noise(void) {
+    for(int page = 0; page < 8; page++){
+        for(int x = 0; x < 128; x++){
+            uint8_t b = rand();
+            masked.back[page][SH1106_ROW_HEADER + x] = b;
+            reference.back[page][SH1106_ROW_HEADER + x] = b;
+        }
+    }
+}
+
+static bool same(void) {
+    for(int page = 0; page < 8; page++){
+        if(memcmp(&masked.back[page][SH1106_ROW_HEADER], &reference.back[page][SH1106_ROW_HEADER], 128) != 0){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void exact(void) {
+    srand(14);
+    int failures = 0;
+    for(int n = 0; n < 20000; n++){
+        uint8_t x = rand() % 140, y = rand() % 72, w = rand() % 140, h = rand() % 72, color = rand() % 2;
+        noise();
+        switch(n % 4){
+        case 0: SH1106_fillRect(&masked, x, y, w, h, color); break;
+        case 1: SH1106_clearRect(&masked, x, y, w, h); color = 0; break;
+        case 2: SH1106_draw_hline(&masked, x, y, w, color); h = 1; break;
+        default: SH1106_drawVLine(&masked, x, y, h, color); w = 1; break;
+        }
+        per_pixel(&reference, x, y, w, h, color);
+        if(!same() && failures++ < 5){
+            fprintf(stderr, "case %d: %u,%u %ux%u color %u differs\n", n % 4, x, y, w, h, color);
+        }
+    }
+    CHECK_EQ(failures, 0);
+}
+
+static void bench(const char *name, int x, int y, int w, int h) {
+    double t0 = bench_now_ns();
+    for(int r = 0; r < REPS; r++){
+        per_pixel(&reference, x, y, w, h, r & 1);
+    }
+    double slow = (bench_now_ns() - t0) / REPS;
+    t0 = bench_now_ns();
+    for(int r = 0; r < REPS; r++){
+        SH1106_fillRect(&masked, x, y, w, h, r & 1);
+    }
+    double fast = (bench_now_ns() - t0) / REPS;
+    int pages = (y + h - 1) / 8 - y / 8 + 1;
+    printf("%-26s %5d drawPixel calls, %6.0f ns; %4d page bytes, %4.0f ns (%.0fx)\n", name, w * h, slow, w * pages,
+           fast, slow / fast);
+}
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c0, 400000);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&masked, i2c0, 0x3C, 128, 64);
+    SH1106_init(&reference, i2c1, 0x3C, 128, 64);
+    exact();
+    bench("progress bar 120x5:", 4, 58, 120, 5);
+    bench("region clear 64x32 at y=4:", 32, 4, 64, 32);
+    bench("whole screen:", 0, 0, 128, 64);
+    bench("hline 128:", 0, 30, 128, 1);
+    bench("vline 64:", 70, 0, 1, 64);
+    return check_result();
+}
@@ -0,0 +1,63 @@
+// Transactions and bus time of a full frame at 400 kHz, before and after packing the page
+// setup and the data into one transaction. "Before" replays the original flush: per page,
+// three single-command transactions and a data transaction, each with its own START,
+// address and STOP. Both must leave the same picture in the panel.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+
+static sh1106_t oled;
+
+static void write_cmd(uint8_t command) {
+    uint8_t buffer[2] = {0x80, command};
+    i2c_write_blocking(i2c0, 0x3C, buffer, sizeof(buffer), false);
+}
+
+static void before_draw(void) {
+    for(uint8_t page = 0; page < oled.pages; page++){
+        uint8_t buffer[1 + 128];
+        write_cmd(SET_PAGE_ADDR | page);
+        write_cmd(LOW_COL_ADDR | 0x02);
+        write_cmd(HIGH_COL_ADDR | 0x00);
+        buffer[0] = 0x40;
+        memcpy(&buffer[1], &oled.front[page][SH1106_ROW_HEADER], 128);
+        i2c_write_blocking(i2c0, 0x3C, buffer, sizeof(buffer), false);
+    }
+}
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    uint32_t txns = sim_i2c_transactions;
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+    printf("init: %u transaction(s) for the whole configuration\n", sim_i2c_transactions - txns);
+    for(int i = 0; i < 40; i++){
+        SH1106_drawCircle(&oled, 64, 32, i, 1);
+    }
+    SH1106_present(&oled);
+
+    txns = sim_i2c_transactions;
+    uint64_t busy = sim_i2c_busy_us;
+    before_draw();
+    uint32_t before_txns = sim_i2c_transactions - txns;
+    uint64_t before_us = sim_i2c_busy_us - busy;
+    CHECK(sim_panel_shows(panel, &oled));
+
+    sim_panel_reset(panel);
+    SH1106_invalidate(&oled);
+    txns = sim_i2c_transactions;
+    busy = sim_i2c_busy_us;
+    SH1106_draw(&oled);
+    uint32_t after_txns = sim_i2c_transactions - txns;
+    uint64_t after_us = sim_i2c_busy_us - busy;
+    CHECK(sim_panel_shows(panel, &oled));
+
+    printf("full frame: before %u transactions, %llu us; after %u transactions, %llu us (%.1f%% less bus time)\n",
+           before_txns, (unsigned long long)before_us, after_txns, (unsigned long long)after_us,
+           100.0 * (before_us - after_us) / before_us);
+    CHECK_EQ(before_txns, 32);
+    CHECK_EQ(after_txns, 8);
+    CHECK(after_us < before_us);
+    return check_result();
+}
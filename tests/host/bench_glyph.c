@@ -0,0 +1,40 @@
+// drawChar as page-byte blits vs the per-pixel reference (ref_glyph.h) on "MM:SS": work per
+// string (pixel calls, framebuffer bytes written) and host time per string.
+#include "bench.h"
+#include "check.h"
+#include "ref_glyph.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+#define REPS 20000
+
+static sh1106_t oled;
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+
+    const char *text = "12:34";
+    for(uint8_t y = 0; y <= 4; y += 4){ //page-aligned, then straddling three pages
+        uint32_t calls = 0;
+        double t0 = bench_now_ns();
+        for(int r = 0; r < REPS; r++){
+            calls = ref_drawString(&oled, text, 0, y, r & 1);
+        }
+        double per_pixel = (bench_now_ns() - t0) / REPS;
+
+        t0 = bench_now_ns();
+        for(int r = 0; r < REPS; r++){
+            SH1106_drawString(&oled, (char *)text, 0, y, r & 1, &font_inconsolata);
+        }
+        double blitted = (bench_now_ns() - t0) / REPS;
+
+        uint32_t pages = font_inconsolata.height / 8 + (y % 8 != 0);
+        uint32_t stores = 5 * font_inconsolata.width * pages;
+        printf("\"%s\" at y=%u: per-pixel %u drawPixel calls, %.0f ns; blit %u byte stores, %.0f ns (%.1fx)\n",
+               text, y, calls, per_pixel, stores, blitted, per_pixel / blitted);
+        CHECK(stores < calls);
+    }
+    return check_result();
+}
@@ -0,0 +1,86 @@
+// Compressed glyphs (tools/asset_encode.py, decoded by blit_rle straight into the
+// framebuffer) against the same glyphs stored raw: size of each table, host time per glyph
+// and decoded bytes per second. Both must draw the same pixels.
+#include <string.h>
+
+#include "bench.h"
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_digits_large.h"
+#include "fonts/font_digits_large_raw.h"
+#include "fonts/font_inconsolata.h"
+#include "fonts/font_inconsolata_rle.h"
+
+#define REPS 2000
+
+static sh1106_t oled;
+
+static uint32_t glyphs_of(const sh1106_font_t *font) {
+    return (uint32_t)(font->last - font->first + 1);
+}
+
+// Bytes of glyph data plus the offsets table, walking every glyph's packets
+static uint32_t rle_size(const sh1106_font_t *font) {
+    uint32_t size = 2 * glyphs_of(font);
+    for(uint32_t g = 0; g < glyphs_of(font); g++){
+        const uint8_t *src = font->glyphs + font->offsets[g];
+        for(uint32_t out = 0; out < font->bytes_per_glyph; ){
+            uint8_t header = src[0];
+            uint32_t n = (header & 0x3F) + 1;
+            switch(header >> 6){
+            case 0: src += 1 + n; break;
+            case 3: src += 2; n++; break;
+            default: src += 1; break;
+            }
+            out += n;
+        }
+        size += (uint32_t)(src - (font->glyphs + font->offsets[g]));
+    }
+    return size;
+}
+
+static double ns_per_glyph(const sh1106_font_t *font) {
+    uint32_t n = glyphs_of(font);
+    double t0 = bench_now_ns();
+    for(int r = 0; r < REPS; r++){
+        for(uint32_t g = 0; g < n; g++){
+            SH1106_drawChar(&oled, font->first + g, 8, 8, 1, font);
+        }
+    }
+    return (bench_now_ns() - t0) / REPS / n;
+}
+
+static bool same_pixels(const sh1106_font_t *a, const sh1106_font_t *b) {
+    static uint8_t drawn[SH1106_MAX_PAGES][SH1106_ROW_BYTES];
+    for(int c = a->first; c <= a->last; c++){
+        for(uint8_t y = 0; y < 16; y += 5){
+            SH1106_clear(&oled);
+            SH1106_drawChar(&oled, c, 8, y, c & 1, a);
+            memcpy(drawn, oled.back, sizeof(drawn));
+            SH1106_clear(&oled);
+            SH1106_drawChar(&oled, c, 8, y, c & 1, b);
+            if(memcmp(drawn, oled.back, sizeof(drawn)) != 0){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void compare(const char *name, const sh1106_font_t *raw, const sh1106_font_t *packed) {
+    CHECK(same_pixels(raw, packed));
+    uint32_t raw_size = glyphs_of(raw) * raw->bytes_per_glyph, packed_size = rle_size(packed);
+    double raw_ns = ns_per_glyph(raw), packed_ns = ns_per_glyph(packed);
+    printf("%s: raw %u B, %.0f ns/glyph (%.0f MB/s); rle %u B (%.0f%%), %.0f ns/glyph (%.0f MB/s)\n", name,
+           raw_size, raw_ns, raw->bytes_per_glyph / raw_ns * 1e3, packed_size, 100.0 * packed_size / raw_size,
+           packed_ns, raw->bytes_per_glyph / packed_ns * 1e3);
+}
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+    compare("digits 24x48", &font_digits_large_raw, &font_digits_large);
+    compare("inconsolata 8x16", &font_inconsolata, &font_inconsolata_rle);
+    return check_result();
+}
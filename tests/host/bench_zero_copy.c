@@ -0,0 +1,99 @@
+// Pages sent straight from the framebuffer rows (the transport's write_run, header patched in
+// place) vs built in a stack buffer (header + memcpy of the page, as the flush used to). All
+// go over the same I2C sim, not decoded into a panel while timed; "bus only" sends prebuilt
+// transactions, so what is left above it is the work of each path. The whole SH1106_draw is
+// timed too: it also keeps the shadow.
+#include <string.h>
+
+#include "bench.h"
+#include "check.h"
+#include "sim.h"
+
+#define REPS 20000
+#define RUNS 5
+
+static sh1106_t oled;
+static uint8_t prebuilt[8][SH1106_ROW_HEADER + 128];
+
+static void header(uint8_t *buf, uint8_t page) {
+    const uint8_t h[SH1106_ROW_HEADER] = {0x80, SET_PAGE_ADDR | page, 0x80, LOW_COL_ADDR | 2, 0x80, HIGH_COL_ADDR, 0x40};
+    memcpy(buf, h, sizeof(h));
+}
+
+static void bus_only(void) {
+    for(uint8_t page = 0; page < 8; page++){
+        i2c_write_blocking(i2c0, 0x3C, prebuilt[page], sizeof(prebuilt[page]), false);
+    }
+}
+
+static void copied(void) {
+    for(uint8_t page = 0; page < 8; page++){
+        uint8_t buf[SH1106_ROW_HEADER + 128];
+        header(buf, page);
+        memcpy(&buf[SH1106_ROW_HEADER], &oled.front[page][SH1106_ROW_HEADER], 128);
+        i2c_write_blocking(i2c0, 0x3C, buf, sizeof(buf), false);
+    }
+}
+
+static void zero_copy(void) {
+    for(uint8_t page = 0; page < 8; page++){
+        oled.transport->write_run(&oled, page, 0, 128);
+    }
+}
+
+static void draw(void) {
+    SH1106_invalidate(&oled);
+    SH1106_draw(&oled);
+}
+
+// Best of RUNS: the least disturbed by the rest of the machine
+static double time_ns(void (*flush)(void)) {
+    double best = 0;
+    for(int run = 0; run < RUNS; run++){
+        double t0 = bench_now_ns();
+        for(int r = 0; r < REPS; r++){
+            flush();
+        }
+        double t = (bench_now_ns() - t0) / REPS;
+        best = run == 0 || t < best ? t : best;
+    }
+    return best;
+}
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+    for(int i = 0; i < 64; i += 3){
+        SH1106_drawLine(&oled, 0, i, 127, 63 - i, 1);
+    }
+    SH1106_present(&oled);
+    for(uint8_t page = 0; page < 8; page++){
+        header(prebuilt[page], page);
+        memcpy(&prebuilt[page][SH1106_ROW_HEADER], &oled.front[page][SH1106_ROW_HEADER], 128);
+    }
+
+    copied();
+    CHECK(sim_panel_shows(panel, &oled));
+    sim_panel_reset(panel);
+    zero_copy();
+    CHECK(sim_panel_shows(panel, &oled));
+
+    sim_i2c_unseen = true;
+    double floor = time_ns(bus_only);
+    double copy = time_ns(copied);
+    double zero = time_ns(zero_copy);
+    double whole = time_ns(draw);
+    sim_i2c_unseen = false;
+    CHECK(oled.online);
+
+    // Bytes each path writes per frame besides the bus: the stack transaction, or the
+    // header saved, patched in and put back in every row
+    uint32_t copy_bytes = 8 * (SH1106_ROW_HEADER + 128), zero_bytes = 8 * 3 * SH1106_ROW_HEADER;
+    printf("full frame over the bus: %.0f ns\n", floor);
+    printf("  copy:      +%.0f ns, %u bytes written\n", copy - floor, copy_bytes);
+    printf("  zero-copy: +%.0f ns, %u bytes written\n", zero - floor, zero_bytes);
+    printf("  SH1106_draw, invalidated: +%.0f ns (zero-copy, plus the shadow update and the dirty spans)\n",
+           whole - floor);
+    return check_result();
+}
@@ -0,0 +1,34 @@
+// Assertions for the host tests: a failed check prints where and what, and the test keeps
+// going so one run reports every failure; check_result() is the exit code.
+#ifndef SH1106_HOST_CHECK_H
+#define SH1106_HOST_CHECK_H
+
+#include <stdio.h>
+
+static int check_failures;
+
+static inline void check_at(int ok, const char *what, const char *file, int line) {
+    if(!ok){
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+        check_failures++;
+    }
+}
+
+static inline void check_eq_at(long long got, long long want, const char *what, const char *file, int line) {
+    if(got != want){
+        fprintf(stderr, "%s:%d: check failed: %s is %lld, expected %lld\n", file, line, what, got, want);
+        check_failures++;
+    }
+}
+
+#define CHECK(cond) check_at((cond) ? 1 : 0, #cond, __FILE__, __LINE__)
+#define CHECK_EQ(got, want) check_eq_at((long long)(got), (long long)(want), #got, __FILE__, __LINE__)
+
+static inline int check_result(void) {
+    if(check_failures){
+        fprintf(stderr, "%d check(s) failed\n", check_failures);
+    }
+    return check_failures ? 1 : 0;
+}
+
+#endif
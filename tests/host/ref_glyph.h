@@ -0,0 +1,41 @@
+// Per-pixel reference for SH1106_drawChar with the 8x16 font, straight from the row-major
+// source table in lib/font_inconsolata.h, drawn the way the driver first did it: one
+// SH1106_drawPixel per cell pixel, background included, the gap column in front.
+#ifndef SH1106_HOST_REF_GLYPH_H
+#define SH1106_HOST_REF_GLYPH_H
+
+#include <stdint.h>
+
+#include "sh1106_i2c.h"
+#include "lib/font_inconsolata.h"
+
+#define REF_WIDTH 8
+#define REF_HEIGHT 16
+
+// Returns the number of SH1106_drawPixel calls.
+static inline uint32_t ref_drawChar(sh1106_t *sh1106, char c, uint8_t x, uint8_t y, uint8_t color) {
+    const uint8_t *rows = &inconsolata[0]; //glyph 0 (blank) for characters the table lacks
+    if(c >= ' ' && c <= '~'){
+        rows = &inconsolata[(c - ' ') * REF_HEIGHT];
+    }
+    uint32_t calls = 0;
+    for(uint8_t i = 0; i < REF_HEIGHT; i++){
+        for(uint8_t col = 0; col <= REF_WIDTH; col++){
+            bool on = col > 0 && (rows[i] & (1 << (REF_WIDTH - col)));
+            // inverted text keeps its two top rows dark, as drawString's gap filling did
+            SH1106_drawPixel(sh1106, x + col, y + i, color ? on : (!on && i >= 2));
+            calls++;
+        }
+    }
+    return calls;
+}
+
+static inline uint32_t ref_drawString(sh1106_t *sh1106, const char *str, uint8_t x, uint8_t y, uint8_t color) {
+    uint32_t calls = 0;
+    for(uint8_t i = 0; str[i] != '\0'; i++){
+        calls += ref_drawChar(sh1106, str[i], x + i * (REF_WIDTH + 1), y, color);
+    }
+    return calls;
+}
+
+#endif
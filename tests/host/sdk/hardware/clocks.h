@@ -0,0 +1,8 @@
+#ifndef SH1106_HOST_HARDWARE_CLOCKS_H
+#define SH1106_HOST_HARDWARE_CLOCKS_H
+#include "pico/stdlib.h"
+
+enum clock_index { clk_sys = 5 };
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif
@@ -0,0 +1,48 @@
+// DMA channels as the driver sees them. sim/sim_dma.c runs a transfer a little at every
+// dma_channel_is_busy, so the CPU side really overlaps with frames in flight.
+#ifndef SH1106_HOST_HARDWARE_DMA_H
+#define SH1106_HOST_HARDWARE_DMA_H
+#include "pico/stdlib.h"
+
+#define NUM_DMA_CHANNELS 12
+
+typedef struct {
+    uint32_t size;
+    bool read_increment;
+    bool write_increment;
+    uint dreq;
+    int chain_to;
+    uint ring_bits;
+} dma_channel_config;
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+typedef struct {
+    volatile uintptr_t read_addr;
+    volatile uintptr_t write_addr;
+    volatile uint32_t transfer_count;
+    volatile uint32_t al3_transfer_count;
+    volatile uintptr_t al3_read_addr_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+} dma_hw_t;
+
+extern dma_hw_t *const dma_hw;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_abort(uint channel);
+
+#endif
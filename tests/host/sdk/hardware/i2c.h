@@ -0,0 +1,50 @@
+// I2C block as the driver sees it: the blocking calls, plus the registers its DMA path
+// programs directly. sim/sim_i2c.c delivers what is written to the panels in sim/panel.c.
+#ifndef SH1106_HOST_HARDWARE_I2C_H
+#define SH1106_HOST_HARDWARE_I2C_H
+#include "pico/stdlib.h"
+
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t status;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t *hw;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u
+#define I2C_IC_STATUS_MST_ACTIVITY_BITS 0x00000020u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us);
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return i2c->hw;
+}
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c == i2c1;
+}
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return 32 + 2 * i2c_hw_index(i2c) + (is_tx ? 0 : 1);
+}
+
+#endif
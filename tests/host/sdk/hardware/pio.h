@@ -0,0 +1,41 @@
+// One PIO block with the registers the SH1106 transmitter touches. sim/sim_pio.c runs the
+// sh1106_spi program as a byte-level model (D/C, count - 1, bytes).
+#ifndef SH1106_HOST_HARDWARE_PIO_H
+#define SH1106_HOST_HARDWARE_PIO_H
+#include "pico/stdlib.h"
+
+typedef struct {
+    volatile uint32_t execctrl;
+} pio_sm_hw_t;
+
+typedef struct {
+    volatile uint32_t fdebug;
+    volatile uint32_t txf[4];
+    pio_sm_hw_t sm[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+extern pio_hw_t pio0_hw;
+#define pio0 (&pio0_hw)
+
+#define PIO_FDEBUG_TXSTALL_LSB 24
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB 7
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS 0x00000f80u
+
+typedef struct {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_restart(PIO pio, uint sm);
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+uint pio_encode_jmp(uint addr);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+
+#endif
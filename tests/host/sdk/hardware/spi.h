@@ -0,0 +1,12 @@
+#ifndef SH1106_HOST_HARDWARE_SPI_H
+#define SH1106_HOST_HARDWARE_SPI_H
+#include "pico/stdlib.h"
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t spi0_inst;
+#define spi0 (&spi0_inst)
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+
+#endif
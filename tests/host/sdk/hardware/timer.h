@@ -0,0 +1,4 @@
+#ifndef SH1106_HOST_HARDWARE_TIMER_H
+#define SH1106_HOST_HARDWARE_TIMER_H
+#include "pico/stdlib.h"
+#endif
@@ -0,0 +1,4 @@
+#ifndef SH1106_HOST_PICO_MALLOC_H
+#define SH1106_HOST_PICO_MALLOC_H
+#include <stdlib.h>
+#endif
@@ -0,0 +1,49 @@
+// Host stand-in for the parts of the Pico SDK the display code uses. Time is virtual
+// (sim/sim_sdk.c): it only moves when the code waits, sleeps or spins.
+#ifndef SH1106_HOST_PICO_STDLIB_H
+#define SH1106_HOST_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+absolute_time_t get_absolute_time(void);
+absolute_time_t make_timeout_time_us(uint64_t us);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us);
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+uint32_t to_ms_since_boot(absolute_time_t t);
+bool time_reached(absolute_time_t t);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us_32(uint32_t us);
+void tight_loop_contents(void);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+enum gpio_function { GPIO_FUNC_SPI = 1, GPIO_FUNC_I2C = 3, GPIO_FUNC_SIO = 5, GPIO_FUNC_NULL = 0x1f };
+enum gpio_drive_strength { GPIO_DRIVE_STRENGTH_2MA, GPIO_DRIVE_STRENGTH_4MA, GPIO_DRIVE_STRENGTH_8MA,
+                           GPIO_DRIVE_STRENGTH_12MA };
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_pull_up(uint gpio);
+void gpio_disable_pulls(uint gpio);
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive);
+
+#endif
@@ -0,0 +1,16 @@
+// Stands in for the header pioasm generates from lib/sh1106_pio.pio: the program is run by
+// the model in sim/sim_pio.c instead.
+#ifndef SH1106_HOST_SH1106_PIO_PIO_H
+#define SH1106_HOST_SH1106_PIO_PIO_H
+#include "hardware/pio.h"
+
+static const pio_program_t sh1106_spi_program = {NULL, 0, -1};
+
+void sim_pio_program_init(PIO pio, uint sm, uint offset, uint mosi_pin, uint sck_pin, uint dc_pin, float clkdiv);
+
+static inline void sh1106_spi_program_init(PIO pio, uint sm, uint offset, uint mosi_pin, uint sck_pin,
+                                           uint dc_pin, float clkdiv) {
+    sim_pio_program_init(pio, sm, offset, mosi_pin, sck_pin, dc_pin, clkdiv);
+}
+
+#endif
@@ -0,0 +1,112 @@
+// SH1106 command decoder and display RAM (datasheet "Commands"), enough for everything the
+// driver sends: addressing, the two-byte setup commands, display/inverse/start line.
+#include <string.h>
+
+#include "sim.h"
+
+static void log_entry(sim_panel_t *panel, uint16_t entry) {
+    if(panel->log_len < SIM_PANEL_LOG){
+        panel->log[panel->log_len] = entry;
+    }
+    panel->log_len++;
+}
+
+void sim_panel_reset(sim_panel_t *panel) {
+    memset(panel->ram, 0xA5, sizeof(panel->ram)); //RAM is undefined after power-on
+    panel->page = 0;
+    panel->col = 0;
+    panel->start_line = 0;
+    panel->offset = 0;
+    panel->contrast = 0x80;
+    panel->display_on = false;
+    panel->inverse = false;
+    panel->charge_pump = true;
+    panel->seg_remap = false;
+    panel->scan_flip = false;
+    panel->arg_of = 0;
+}
+
+void sim_panel_clear_log(sim_panel_t *panel) {
+    panel->cmd_bytes = 0;
+    panel->data_bytes = 0;
+    panel->log_len = 0;
+}
+
+static void argument(sim_panel_t *panel, uint8_t b) {
+    switch(panel->arg_of){
+    case SET_CONTRAST:
+        panel->contrast = b;
+        break;
+    case SET_CHARGE_PUMP:
+        panel->charge_pump = b & 0x01;
+        break;
+    case SET_DISP_OFFSET:
+        panel->offset = b & 0x3F;
+        break;
+    default: //multiplex ratio, clock, precharge, COM pins, VCOMH: not modelled
+        break;
+    }
+    panel->arg_of = 0;
+}
+
+void sim_panel_cmd(sim_panel_t *panel, uint8_t b) {
+    panel->cmd_bytes++;
+    log_entry(panel, b);
+    if(panel->arg_of){
+        argument(panel, b);
+        return;
+    }
+    if(b <= 0x0F){
+        panel->col = (panel->col & 0xF0) | b;
+    }else if(b <= 0x1F){
+        panel->col = (panel->col & 0x0F) | (uint8_t)((b & 0x0F) << 4);
+    }else if(b >= 0x40 && b <= 0x7F){
+        panel->start_line = b & 0x3F;
+    }else if(b >= 0xB0 && b <= 0xB7){
+        panel->page = b & 0x07;
+    }else{
+        switch(b){
+        case SET_CONTRAST: case SET_CHARGE_PUMP: case SET_DISP_OFFSET:
+        case 0xA8: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            panel->arg_of = b;
+            break;
+        case SET_SEG_REMAP: case SET_SEG_REMAP | 0x01:
+            panel->seg_remap = b & 0x01;
+            break;
+        case SET_SCAN_DIR: case SET_SCAN_DIR | 0x08:
+            panel->scan_flip = b & 0x08;
+            break;
+        case SET_NORM_INV: case SET_NORM_INV | 0x01:
+            panel->inverse = b & 0x01;
+            break;
+        case SET_DISP: case SET_DISP | 0x01:
+            panel->display_on = b & 0x01;
+            break;
+        default: //NOP, pump voltage, entire display on, read-modify-write: no visible state
+            break;
+        }
+    }
+}
+
+// The column pointer stops at the last RAM column; further bytes are lost.
+void sim_panel_data(sim_panel_t *panel, uint8_t b) {
+    panel->data_bytes++;
+    log_entry(panel, SIM_LOG_DATA | b);
+    if(panel->col < sizeof(panel->ram[0])){
+        panel->ram[panel->page][panel->col++] = b;
+    }
+}
+
+uint8_t sim_panel_status(const sim_panel_t *panel) {
+    return panel->display_on ? 0x00 : STATUS_DISP_OFF;
+}
+
+bool sim_panel_shows(const sim_panel_t *panel, const sh1106_t *sh1106) {
+    for(uint8_t page = 0; page < sh1106->pages; page++){
+        if(memcmp(&panel->ram[page][sh1106->col_offset], &sh1106->front[page][SH1106_ROW_HEADER],
+                  sh1106->width) != 0){
+            return false;
+        }
+    }
+    return true;
+}
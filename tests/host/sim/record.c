@@ -0,0 +1,26 @@
+// Recording transport: no bus, every command and data byte goes straight into a panel model
+// and its log. It is the reference stream the real backends are compared against.
+#include "sim.h"
+
+sim_panel_t sim_recorded;
+
+static bool record_cmds(sh1106_t *sh1106, const uint8_t *commands, size_t n) {
+    for(size_t i = 0; i < n; i++){
+        sim_panel_cmd(&sim_recorded, commands[i]);
+    }
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+static bool record_data(sh1106_t *sh1106, const uint8_t *data, size_t n) {
+    for(size_t i = 0; i < n; i++){
+        sim_panel_data(&sim_recorded, data[i]);
+    }
+    sh1106->bytes_sent += n;
+    return true;
+}
+
+const sh1106_transport_t sim_record_transport = {
+    .write_cmds = record_cmds,
+    .write_data = record_data,
+};
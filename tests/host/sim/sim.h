@@ -0,0 +1,94 @@
+// Host models behind the stub SDK headers in ../sdk: a virtual clock, the I2C block, SPI,
+// the PIO transmitter and the DMA engine feeding them, and an SH1106 that decodes what
+// arrives on its bus into its own RAM. Tests attach panels, inject bus faults and then
+// check the panel RAM and the byte counts against what the driver presented.
+#ifndef SH1106_HOST_SIM_H
+#define SH1106_HOST_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "sh1106_i2c.h"
+
+// ---- panel.c: the display controller ----
+
+#define SIM_PANEL_LOG (1 << 16)
+#define SIM_LOG_DATA 0x100 // log entries: command byte, or SIM_LOG_DATA | data byte
+
+typedef struct {
+    uint8_t ram[8][132];
+    uint8_t page, col;      // where the next data byte goes
+    uint8_t start_line, offset, contrast;
+    bool display_on, inverse, charge_pump, seg_remap, scan_flip;
+    uint8_t arg_of;         // two-byte command waiting for its argument, 0 if none
+    uint32_t cmd_bytes;     // bytes received, without bus framing (address, control bytes)
+    uint32_t data_bytes;
+    uint32_t log_len;       // entries in log, capped at SIM_PANEL_LOG
+    uint16_t log[SIM_PANEL_LOG];
+} sim_panel_t;
+
+void sim_panel_reset(sim_panel_t *panel); // power-on state, RAM filled with a garbage pattern
+void sim_panel_cmd(sim_panel_t *panel, uint8_t b);
+void sim_panel_data(sim_panel_t *panel, uint8_t b);
+uint8_t sim_panel_status(const sim_panel_t *panel);
+// True when the panel RAM holds the front buffer of `sh1106` over its whole area.
+bool sim_panel_shows(const sim_panel_t *panel, const sh1106_t *sh1106);
+void sim_panel_clear_log(sim_panel_t *panel);
+
+// ---- sim_sdk.c: clock and GPIO ----
+
+extern uint64_t sim_now_us;
+void sim_advance_us(uint64_t us);
+bool sim_gpio_level(uint gpio);
+
+// ---- sim_i2c.c: both I2C blocks ----
+
+typedef enum {
+    SIM_BUS_OK,
+    SIM_BUS_NACK,  // every transfer is NACKed at once
+    SIM_BUS_STUCK, // a slave holds SDA: transfers run into their timeout, DMA stalls
+    SIM_BUS_HELD,  // as STUCK, but SDA reads low and SIM_HELD_PULSES SCL pulses release it
+} sim_fault_t;
+
+#define SIM_HELD_PULSES 5
+
+sim_panel_t *sim_i2c_attach(i2c_inst_t *i2c, uint8_t address); // panel in reset at `address`
+void sim_i2c_detach(i2c_inst_t *i2c, uint8_t address);
+void sim_i2c_set_fault(i2c_inst_t *i2c, sim_fault_t fault);
+extern uint sim_i2c_max_baud;          // transfers above this rate are NACKed (0: no limit)
+extern uint sim_i2c_flaky_baud;        // ... and one in SIM_FLAKY_EVERY above this one (0: none)
+#define SIM_FLAKY_EVERY 5
+extern bool sim_i2c_unseen;            // benches: transfers are ACKed and timed, not decoded
+extern uint32_t sim_i2c_transactions;  // START ... STOP on either bus, NACKed ones included
+extern uint64_t sim_i2c_busy_us;       // bus time of all I2C traffic (9 bits per byte)
+// Hooks for sim_sdk.c: the bus lines as GPIOs, for the bus clear
+bool sim_i2c_sda_low(uint gpio);
+void sim_i2c_scl_pulse(uint gpio);  // SCL driven low, then released
+// Hooks for sim_dma.c: DMA writes into IC_DATA_CMD
+bool sim_i2c_data_cmd(volatile void *addr);
+void sim_i2c_dma_begin(volatile uint32_t *data_cmd);
+void sim_i2c_dma_word(volatile uint32_t *data_cmd, uint32_t word);
+bool sim_i2c_dma_stalled(volatile uint32_t *data_cmd);
+
+// ---- sim_spi.c: SPI block, PIO transmitter and the 4-wire panels on them ----
+
+sim_panel_t *sim_spi_attach(uint cs_pin, uint dc_pin);
+void sim_spi_byte(bool data, uint8_t b); // to every attached panel whose CS is low
+// Hooks for sim_dma.c: DMA writes into a PIO TX FIFO
+bool sim_pio_txf(volatile uint32_t *addr);
+void sim_pio_txf_byte(volatile uint32_t *txf, uint32_t word);
+
+// ---- record.c: transport without a bus, straight into sim_recorded ----
+
+extern const sh1106_transport_t sim_record_transport;
+extern sim_panel_t sim_recorded;
+
+// ---- sim_dma.c ----
+
+extern uint sim_dma_burst; // elements each busy channel moves per step
+void sim_dma_step(void);   // one burst per busy channel, then 1 us
+void sim_dma_run(void);    // moves everything in flight to the end
+
+#endif
@@ -0,0 +1,180 @@
+// DMA engine: every dma_channel_is_busy or time_reached moves up to sim_dma_burst elements on
+// each busy channel, so frames overlap with whatever the CPU does between polls. Writes into another
+// channel's alias registers are modelled (TRANS_COUNT, READ_ADDR_TRIG), which is what the PIO
+// transport's control channel uses; a trigger with a zero count does nothing and does not
+// chain, as on the RP2040.
+#include "sim.h"
+#include <stdlib.h>
+
+#include "hardware/dma.h"
+
+static dma_hw_t dma;
+dma_hw_t *const dma_hw = &dma;
+uint sim_dma_burst = 8;
+
+static struct {
+    bool claimed;
+    bool busy;
+    dma_channel_config cfg;
+    uint32_t reload; //count a (re)trigger starts with
+} chans[NUM_DMA_CHANNELS];
+
+int dma_claim_unused_channel(bool required) {
+    for(int ch = 0; ch < NUM_DMA_CHANNELS; ch++){
+        if(!chans[ch].claimed){
+            chans[ch].claimed = true;
+            return ch;
+        }
+    }
+    if(required){
+        abort(); //as panic() in the SDK
+    }
+    return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {DMA_SIZE_32, true, false, 0x3f, (int)channel, 0};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->chain_to = (int)chain_to;
+}
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->ring_bits = write ? size_bits : 0; //read rings are not used here
+}
+
+static void trigger(uint ch) {
+    dma.ch[ch].transfer_count = chans[ch].reload;
+    chans[ch].busy = chans[ch].reload > 0;
+    if(chans[ch].busy && sim_i2c_data_cmd((volatile void *)dma.ch[ch].write_addr)){
+        sim_i2c_dma_begin((volatile uint32_t *)dma.ch[ch].write_addr);
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger_now) {
+    chans[channel].cfg = *config;
+    dma.ch[channel].write_addr = (uintptr_t)write_addr;
+    dma.ch[channel].read_addr = (uintptr_t)read_addr;
+    chans[channel].reload = transfer_count;
+    if(trigger_now){
+        trigger(channel);
+    }
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger_now) {
+    dma.ch[channel].read_addr = (uintptr_t)read_addr;
+    if(trigger_now){
+        trigger(channel);
+    }
+}
+
+static dma_channel_hw_t *register_owner(uintptr_t addr) {
+    if(addr < (uintptr_t)&dma || addr >= (uintptr_t)(&dma + 1)){
+        return NULL;
+    }
+    return &dma.ch[(addr - (uintptr_t)&dma) / sizeof(dma.ch[0])];
+}
+
+// Control-block transfer into another channel's alias registers. Pointers are 64-bit on the
+// host, so each element is as wide as the register it lands in and read at that alignment,
+// and the 8-byte write ring becomes the count / read-address-trigger pair.
+static void move_to_register(uint ch, dma_channel_hw_t *target) {
+    dma_channel_hw_t *hw = &dma.ch[ch];
+    uint target_ch = (uint)(target - dma.ch);
+    if(hw->write_addr == (uintptr_t)&target->al3_transfer_count){
+        uint32_t count = *(const uint32_t *)hw->read_addr;
+        hw->read_addr += sizeof(uint32_t);
+        target->al3_transfer_count = count;
+        chans[target_ch].reload = count;
+        hw->write_addr = (uintptr_t)&target->al3_read_addr_trig;
+    }else{
+        hw->read_addr = (hw->read_addr + sizeof(uintptr_t) - 1) & ~(uintptr_t)(sizeof(uintptr_t) - 1);
+        uintptr_t read = *(const uintptr_t *)hw->read_addr;
+        hw->read_addr += sizeof(uintptr_t);
+        hw->write_addr = (uintptr_t)&target->al3_transfer_count;
+        target->read_addr = read;
+        trigger(target_ch);
+    }
+}
+
+static uint32_t read_element(uintptr_t addr, uint32_t size) {
+    switch(size){
+    case DMA_SIZE_8: return *(const uint8_t *)addr;
+    case DMA_SIZE_16: return *(const uint16_t *)addr;
+    default: return *(const uint32_t *)addr;
+    }
+}
+
+// One element into a peripheral FIFO (fixed write address).
+static void move_to_fifo(uint ch) {
+    dma_channel_hw_t *hw = &dma.ch[ch];
+    uint32_t value = read_element(hw->read_addr, chans[ch].cfg.size);
+    if(chans[ch].cfg.read_increment){
+        hw->read_addr += 1u << chans[ch].cfg.size;
+    }
+    if(sim_i2c_data_cmd((volatile void *)hw->write_addr)){
+        sim_i2c_dma_word((volatile uint32_t *)hw->write_addr, value);
+    }else if(sim_pio_txf((volatile uint32_t *)hw->write_addr)){
+        sim_pio_txf_byte((volatile uint32_t *)hw->write_addr, value);
+    }
+}
+
+static bool stalled(uint ch) {
+    uintptr_t write = dma.ch[ch].write_addr;
+    return sim_i2c_data_cmd((volatile void *)write) && sim_i2c_dma_stalled((volatile uint32_t *)write);
+}
+
+void sim_dma_step(void) {
+    for(uint ch = 0; ch < NUM_DMA_CHANNELS; ch++){
+        for(uint n = 0; n < sim_dma_burst && chans[ch].busy && !stalled(ch); n++){
+            dma_channel_hw_t *target = register_owner(dma.ch[ch].write_addr);
+            target ? move_to_register(ch, target) : move_to_fifo(ch);
+            if(--dma.ch[ch].transfer_count == 0){
+                chans[ch].busy = false;
+                if(chans[ch].cfg.chain_to != (int)ch){
+                    trigger((uint)chans[ch].cfg.chain_to);
+                }
+            }
+        }
+    }
+    sim_advance_us(1);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    sim_dma_step();
+    return chans[channel].busy;
+}
+
+void dma_channel_abort(uint channel) {
+    chans[channel].busy = false;
+    dma.ch[channel].transfer_count = 0;
+}
+
+void sim_dma_run(void) {
+    for(bool busy = true; busy; ){
+        sim_dma_step();
+        busy = false;
+        for(uint ch = 0; ch < NUM_DMA_CHANNELS; ch++){
+            busy |= chans[ch].busy && !stalled(ch);
+        }
+    }
+}
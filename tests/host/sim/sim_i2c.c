@@ -0,0 +1,223 @@
+// Both I2C blocks with up to four panels each. Transfers are decoded by the SH1106 control
+// bytes (Co, D/C) and cost 9 bit times per byte, address included, at the bus rate.
+#include "sim.h"
+
+#define MAX_PANELS 4
+#define TXN_MAX 2048
+
+typedef struct {
+    bool used;
+    uint8_t address;
+    sim_panel_t panel;
+} slot_t;
+
+typedef struct {
+    i2c_hw_t hw;
+    sim_fault_t fault;
+    uint8_t scl_pulses;   //SIM_BUS_HELD: clocked out of the stuck byte so far
+    slot_t slots[MAX_PANELS];
+    uint8_t txn[TXN_MAX]; //DMA transaction being assembled up to its STOP
+    size_t txn_len;
+} bus_t;
+
+static bus_t buses[2];
+i2c_inst_t i2c0_inst = {&buses[0].hw, 0};
+i2c_inst_t i2c1_inst = {&buses[1].hw, 0};
+
+uint sim_i2c_max_baud;
+uint sim_i2c_flaky_baud;
+bool sim_i2c_unseen;
+uint32_t sim_i2c_transactions;
+uint64_t sim_i2c_busy_us;
+
+static bus_t *bus_of(i2c_inst_t *i2c) {
+    return &buses[i2c_hw_index(i2c)];
+}
+
+static void bus_time(i2c_inst_t *i2c, size_t bytes) {
+    uint baud = i2c->baudrate ? i2c->baudrate : 100000;
+    uint64_t us = (bytes * 9 * 1000000ull + baud - 1) / baud;
+    sim_i2c_busy_us += us;
+    sim_advance_us(us);
+}
+
+static sim_panel_t *panel_at(bus_t *bus, uint8_t address) {
+    for(int i = 0; i < MAX_PANELS; i++){
+        if(bus->slots[i].used && bus->slots[i].address == address){
+            return &bus->slots[i].panel;
+        }
+    }
+    return NULL;
+}
+
+sim_panel_t *sim_i2c_attach(i2c_inst_t *i2c, uint8_t address) {
+    bus_t *bus = bus_of(i2c);
+    bus->hw.status = I2C_IC_STATUS_TFE_BITS;
+    sim_panel_t *panel = panel_at(bus, address);
+    for(int i = 0; !panel && i < MAX_PANELS; i++){
+        if(!bus->slots[i].used){
+            bus->slots[i].used = true;
+            bus->slots[i].address = address;
+            panel = &bus->slots[i].panel;
+        }
+    }
+    sim_panel_reset(panel);
+    sim_panel_clear_log(panel);
+    return panel;
+}
+
+void sim_i2c_detach(i2c_inst_t *i2c, uint8_t address) {
+    bus_t *bus = bus_of(i2c);
+    for(int i = 0; i < MAX_PANELS; i++){
+        if(bus->slots[i].used && bus->slots[i].address == address){
+            bus->slots[i].used = false;
+        }
+    }
+}
+
+static bool stuck(const bus_t *bus) {
+    return bus->fault == SIM_BUS_STUCK || bus->fault == SIM_BUS_HELD;
+}
+
+void sim_i2c_set_fault(i2c_inst_t *i2c, sim_fault_t fault) {
+    bus_t *bus = bus_of(i2c);
+    bus->fault = fault;
+    bus->scl_pulses = 0;
+    bus->hw.status = stuck(bus) ? I2C_IC_STATUS_MST_ACTIVITY_BITS : I2C_IC_STATUS_TFE_BITS;
+}
+
+// RP2040 pin mapping: GPIO 4k / 4k+1 can be SDA / SCL of i2c0, 4k+2 / 4k+3 of i2c1.
+bool sim_i2c_sda_low(uint gpio) {
+    return gpio % 4 == 0 || gpio % 4 == 2 ? buses[gpio % 4 / 2].fault == SIM_BUS_HELD : false;
+}
+
+void sim_i2c_scl_pulse(uint gpio) {
+    if(gpio % 4 != 1 && gpio % 4 != 3){
+        return;
+    }
+    bus_t *bus = &buses[gpio % 4 / 2];
+    if(bus->fault == SIM_BUS_HELD && ++bus->scl_pulses == SIM_HELD_PULSES){
+        bus->fault = SIM_BUS_OK; //the slave finished its byte and let go of SDA
+        bus->hw.status = I2C_IC_STATUS_TFE_BITS;
+    }
+}
+
+static bool acked(i2c_inst_t *i2c, uint8_t address) {
+    static uint32_t flaky;
+    if(sim_i2c_flaky_baud && i2c->baudrate > sim_i2c_flaky_baud && ++flaky % SIM_FLAKY_EVERY == 0){
+        return false;
+    }
+    return bus_of(i2c)->fault == SIM_BUS_OK && (!sim_i2c_max_baud || i2c->baudrate <= sim_i2c_max_baud) &&
+           panel_at(bus_of(i2c), address);
+}
+
+// One write transaction: Co=1 control bytes carry a single byte, Co=0 ones the rest.
+static bool deliver(i2c_inst_t *i2c, uint8_t address, const uint8_t *src, size_t len) {
+    sim_i2c_transactions++;
+    if(!acked(i2c, address)){
+        bus_time(i2c, 1);
+        return false;
+    }
+    bus_time(i2c, 1 + len);
+    if(sim_i2c_unseen){
+        return true;
+    }
+    sim_panel_t *panel = panel_at(bus_of(i2c), address);
+    size_t i = 0;
+    while(i < len){
+        uint8_t control = src[i++];
+        bool data = control & 0x40;
+        size_t end = (control & 0x80) ? (i < len ? i + 1 : i) : len;
+        for(; i < end; i++){
+            data ? sim_panel_data(panel, src[i]) : sim_panel_cmd(panel, src[i]);
+        }
+    }
+    return true;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    bus_of(i2c)->hw.status = I2C_IC_STATUS_TFE_BITS;
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us) {
+    (void)nostop;
+    if(stuck(bus_of(i2c))){
+        sim_i2c_transactions++;
+        sim_advance_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    return deliver(i2c, addr, src, len) ? (int)len : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us) {
+    (void)nostop;
+    sim_i2c_transactions++;
+    if(stuck(bus_of(i2c))){
+        sim_advance_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    if(!acked(i2c, addr)){
+        bus_time(i2c, 1);
+        return PICO_ERROR_GENERIC;
+    }
+    bus_time(i2c, 1 + len);
+    for(size_t i = 0; i < len; i++){
+        dst[i] = sim_panel_status(panel_at(bus_of(i2c), addr));
+    }
+    return (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return i2c_write_timeout_us(i2c, addr, src, len, nostop, 0);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    return i2c_read_timeout_us(i2c, addr, dst, len, nostop, 0);
+}
+
+static i2c_inst_t *inst_of(volatile uint32_t *data_cmd) {
+    if(data_cmd == &i2c0_inst.hw->data_cmd){
+        return i2c0;
+    }
+    return data_cmd == &i2c1_inst.hw->data_cmd ? i2c1 : NULL;
+}
+
+bool sim_i2c_dma_stalled(volatile uint32_t *data_cmd) {
+    return stuck(bus_of(inst_of(data_cmd)));
+}
+
+// IC_DATA_CMD words from the DMA: a STOP ends the transaction. After a NACK the controller
+// flushes what the DMA keeps pushing until the abort is cleared (a new frame, here).
+void sim_i2c_dma_word(volatile uint32_t *data_cmd, uint32_t word) {
+    i2c_inst_t *i2c = inst_of(data_cmd);
+    bus_t *bus = bus_of(i2c);
+    if(bus->hw.raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS){
+        return;
+    }
+    if(bus->txn_len < TXN_MAX){
+        bus->txn[bus->txn_len++] = (uint8_t)word;
+    }
+    if(word & I2C_IC_DATA_CMD_STOP_BITS){
+        if(!deliver(i2c, (uint8_t)bus->hw.tar, bus->txn, bus->txn_len)){
+            bus->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+        }
+        bus->txn_len = 0;
+    }
+}
+
+void sim_i2c_dma_begin(volatile uint32_t *data_cmd) {
+    bus_t *bus = bus_of(inst_of(data_cmd));
+    bus->hw.raw_intr_stat = 0;
+    bus->txn_len = 0;
+}
+
+bool sim_i2c_data_cmd(volatile void *addr) {
+    return inst_of((volatile uint32_t *)addr) != NULL;
+}
@@ -0,0 +1,148 @@
+// Virtual time and GPIO. The clock only moves when the code under test waits: sleeps, busy
+// waits and spins (1 us per tight_loop_contents), plus the bus time of every transfer.
+#include "sim.h"
+#include "hardware/clocks.h"
+
+#define MAX_ALARMS 4
+#define MAX_GPIO 30
+
+uint64_t sim_now_us;
+
+static struct {
+    alarm_callback_t callback;
+    void *user_data;
+    uint64_t at;
+} alarms[MAX_ALARMS];
+
+static bool gpio_level[MAX_GPIO];
+static bool gpio_out[MAX_GPIO];
+
+void sim_advance_us(uint64_t us) {
+    sim_now_us += us;
+    for(int i = 0; i < MAX_ALARMS; i++){
+        if(alarms[i].callback && sim_now_us >= alarms[i].at){
+            alarm_callback_t callback = alarms[i].callback;
+            alarms[i].callback = NULL; //one-shot: the callbacks used here return 0
+            callback(i + 1, alarms[i].user_data);
+        }
+    }
+}
+
+absolute_time_t get_absolute_time(void) {
+    return sim_now_us;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return sim_now_us + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return sim_now_us + ms * 1000ull;
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    return t + us;
+}
+
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return t + ms * 1000ull;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+bool time_reached(absolute_time_t t) {
+    sim_dma_step(); //the DMA keeps going while the CPU watches the clock
+    return sim_now_us >= t;
+}
+
+void sleep_us(uint64_t us) {
+    sim_advance_us(us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sim_advance_us(ms * 1000ull);
+}
+
+void busy_wait_us_32(uint32_t us) {
+    sim_advance_us(us);
+}
+
+void tight_loop_contents(void) {
+    sim_advance_us(1);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)fire_if_past;
+    for(int i = 0; i < MAX_ALARMS; i++){
+        if(!alarms[i].callback){
+            alarms[i].callback = callback;
+            alarms[i].user_data = user_data;
+            alarms[i].at = sim_now_us + ms * 1000ull;
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    if(id < 1 || id > MAX_ALARMS || !alarms[id - 1].callback){
+        return false;
+    }
+    alarms[id - 1].callback = NULL;
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    (void)clk_index;
+    return 125000000;
+}
+
+void gpio_init(uint gpio) {
+    gpio_level[gpio] = false;
+    gpio_out[gpio] = false;
+}
+
+// An output driving low that goes back to input is one SCL pulse, if the pin is an SCL
+void gpio_set_dir(uint gpio, bool out) {
+    if(gpio_out[gpio] && !out && !gpio_level[gpio]){
+        sim_i2c_scl_pulse(gpio);
+    }
+    gpio_out[gpio] = out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    gpio_level[gpio] = value;
+}
+
+// Open-drain bus lines read high unless driven low or held by a slave (SIM_BUS_HELD).
+bool gpio_get(uint gpio) {
+    return !(gpio_out[gpio] && !gpio_level[gpio]) && !sim_i2c_sda_low(gpio);
+}
+
+bool sim_gpio_level(uint gpio) {
+    return gpio_level[gpio];
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_pull_up(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_disable_pulls(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive) {
+    (void)gpio;
+    (void)drive;
+}
@@ -0,0 +1,156 @@
+// 4-wire panels: a byte reaches every attached panel whose CS is low, as a command or as
+// data depending on D/C. The SPI block reads D/C from its pin; the PIO transmitter carries
+// it in the stream (D/C, count - 1, bytes), which sh1106_spi decodes before shifting out.
+#include "sim.h"
+#include "hardware/pio.h"
+#include "hardware/spi.h"
+
+#define MAX_PANELS 4
+
+struct spi_inst {
+    uint baudrate;
+};
+spi_inst_t spi0_inst;
+pio_hw_t pio0_hw;
+
+static struct {
+    bool used;
+    uint cs_pin, dc_pin;
+    sim_panel_t panel;
+} panels[MAX_PANELS];
+
+static struct {
+    int stage; //0: D/C byte next, 1: count next, 2: data bytes
+    bool data;
+    uint left;
+} sm[4];
+
+sim_panel_t *sim_spi_attach(uint cs_pin, uint dc_pin) {
+    for(int i = 0; i < MAX_PANELS; i++){
+        if(!panels[i].used || panels[i].cs_pin == cs_pin){
+            panels[i].used = true;
+            panels[i].cs_pin = cs_pin;
+            panels[i].dc_pin = dc_pin;
+            sim_panel_reset(&panels[i].panel);
+            sim_panel_clear_log(&panels[i].panel);
+            return &panels[i].panel;
+        }
+    }
+    return NULL;
+}
+
+void sim_spi_byte(bool data, uint8_t b) {
+    for(int i = 0; i < MAX_PANELS; i++){
+        if(panels[i].used && !sim_gpio_level(panels[i].cs_pin)){
+            data ? sim_panel_data(&panels[i].panel, b) : sim_panel_cmd(&panels[i].panel, b);
+        }
+    }
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    spi->baudrate = baudrate;
+    return baudrate;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    (void)spi;
+    for(size_t i = 0; i < len; i++){
+        for(int p = 0; p < MAX_PANELS; p++){
+            if(panels[p].used && !sim_gpio_level(panels[p].cs_pin)){
+                bool data = sim_gpio_level(panels[p].dc_pin);
+                data ? sim_panel_data(&panels[p].panel, src[i]) : sim_panel_cmd(&panels[p].panel, src[i]);
+            }
+        }
+    }
+    return (int)len;
+}
+
+// ---- PIO: the sh1106_spi program, one byte at a time ----
+
+void sim_pio_program_init(PIO pio, uint sm_index, uint offset, uint mosi_pin, uint sck_pin, uint dc_pin,
+                          float clkdiv) {
+    (void)mosi_pin;
+    (void)sck_pin;
+    (void)dc_pin;
+    (void)clkdiv;
+    pio->sm[sm_index].execctrl = offset << PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB;
+    sm[sm_index].stage = 0;
+}
+
+static void sm_byte(uint sm_index, uint8_t b) {
+    switch(sm[sm_index].stage){
+    case 0:
+        sm[sm_index].data = b != 0;
+        sm[sm_index].stage = 1;
+        break;
+    case 1:
+        sm[sm_index].left = b + 1u;
+        sm[sm_index].stage = 2;
+        break;
+    default:
+        sim_spi_byte(sm[sm_index].data, b);
+        if(--sm[sm_index].left == 0){
+            sm[sm_index].stage = 0;
+        }
+        break;
+    }
+}
+
+bool sim_pio_txf(volatile uint32_t *addr) {
+    return addr >= &pio0_hw.txf[0] && addr < &pio0_hw.txf[4];
+}
+
+// Byte-wide DMA stores land in all four lanes: the program shifts out the top one.
+void sim_pio_txf_byte(volatile uint32_t *txf, uint32_t word) {
+    sm_byte((uint)(txf - pio0_hw.txf), (uint8_t)word);
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    (void)pio;
+    (void)required;
+    return 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    (void)pio;
+    (void)program;
+    return 0;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm_index, uint32_t data) {
+    sm_byte(sm_index, (uint8_t)(data >> 24));
+    pio->fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + sm_index); //drained at once: stalls on the next PULL
+}
+
+// Bytes are shifted out as they arrive. TXSTALL is write-1-to-clear on the chip; here the
+// driver's clearing write sets it again, which reads the same since the FIFO is always empty.
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm_index) {
+    (void)pio;
+    (void)sm_index;
+    return true;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm_index) {
+    (void)pio;
+    (void)sm_index;
+}
+
+void pio_sm_restart(PIO pio, uint sm_index) {
+    (void)pio;
+    sm[sm_index].stage = 0;
+}
+
+void pio_sm_exec(PIO pio, uint sm_index, uint instr) {
+    (void)pio;
+    (void)instr;
+    sm[sm_index].stage = 0; //only ever a jump to the first PULL
+}
+
+uint pio_encode_jmp(uint addr) {
+    return addr;
+}
+
+uint pio_get_dreq(PIO pio, uint sm_index, bool is_tx) {
+    (void)pio;
+    return sm_index + (is_tx ? 0 : 4);
+}
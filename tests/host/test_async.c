@@ -0,0 +1,113 @@
+// SH1106_draw_async over the I2C DMA stream: frames complete with one callback, a frame asked
+// for while one is in flight goes out after it, blocking writes wait their turn, and a frame
+// cut off by a NACK or a stuck bus leaves its spans pending for the draw after SH1106_reinit.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+static sh1106_t oled;
+static sim_panel_t *panel;
+static int done_calls;
+
+static void on_done(sh1106_t *sh1106, void *user) {
+    done_calls++;
+    CHECK(user == &oled);
+}
+
+static void scene(const char *text, uint8_t y) {
+    SH1106_drawString(&oled, (char *)text, 16, y, 1, &font_inconsolata);
+    SH1106_present(&oled);
+}
+
+static void wait_idle(void) {
+    while(SH1106_busy(&oled)){
+    }
+}
+
+static bool same_spans(const sh1106_dirty_t *a, const sh1106_dirty_t *b) {
+    if(a->pages != b->pages){
+        return false;
+    }
+    for(int page = 0; page < SH1106_MAX_PAGES; page++){
+        if((a->pages & (1 << page)) && (a->min[page] != b->min[page] || a->max[page] != b->max[page])){
+            return false;
+        }
+    }
+    return true;
+}
+
+// The bus fails a few polls into the frame: the frame is dropped, its spans are pending
+// again and the panel gets them once the bus is back and the panel re-initialised.
+static void dropped_frame(sim_fault_t fault, const char *text) {
+    scene(text, 32);
+    sh1106_dirty_t spans = oled.pending;
+    uint32_t errors = oled.async_errors;
+    done_calls = 0;
+    CHECK(SH1106_draw_async(&oled, on_done, &oled));
+    for(int i = 0; i < 3; i++){
+        SH1106_poll(&oled);
+    }
+    sim_i2c_set_fault(i2c0, fault);
+    wait_idle();
+    CHECK_EQ(oled.async_errors, errors + 1);
+    CHECK_EQ(done_calls, 1);
+    CHECK(!oled.online);
+    CHECK(same_spans(&oled.pending, &spans));
+
+    sim_i2c_set_fault(i2c0, SIM_BUS_OK);
+    CHECK(SH1106_reinit(&oled));
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+}
+
+int main(void) {
+    sim_dma_burst = 2;
+    panel = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+
+    scene("12:34", 0);
+    CHECK(SH1106_draw_async(&oled, on_done, &oled));
+    CHECK(SH1106_busy(&oled));
+    wait_idle();
+    CHECK_EQ(done_calls, 1);
+    CHECK(sim_panel_shows(panel, &oled));
+
+    // Second frame while the first is in flight: remembered, sent after it, one callback each
+    done_calls = 0;
+    scene("12:35", 0);
+    CHECK(SH1106_draw_async(&oled, on_done, &oled));
+    scene("12:36", 16);
+    CHECK(!SH1106_draw_async(&oled, on_done, &oled));
+    CHECK(oled.async_pending);
+    wait_idle();
+    CHECK_EQ(done_calls, 2);
+    CHECK(sim_panel_shows(panel, &oled));
+
+    // A blocking command waits for the frame instead of interleaving with its stream
+    scene("00:00", 0);
+    CHECK(SH1106_draw_async(&oled, NULL, NULL));
+    SH1106_setContrast(&oled, 0x20);
+    CHECK_EQ(panel->contrast, 0x20);
+    wait_idle();
+    CHECK(sim_panel_shows(panel, &oled));
+    CHECK_EQ(oled.async_errors, 0);
+
+    dropped_frame(SIM_BUS_NACK, "NACK");
+    dropped_frame(SIM_BUS_STUCK, "STUCK");
+
+    // Same for the blocking flush: a NACK part way leaves the frame pending
+    scene("99:99", 48);
+    sh1106_dirty_t spans = oled.pending;
+    sim_i2c_set_fault(i2c0, SIM_BUS_NACK);
+    SH1106_draw(&oled);
+    CHECK(!oled.online);
+    CHECK(same_spans(&oled.pending, &spans));
+    sim_i2c_set_fault(i2c0, SIM_BUS_OK);
+    CHECK(SH1106_reinit(&oled));
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+    return check_result();
+}
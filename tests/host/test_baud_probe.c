@@ -0,0 +1,42 @@
+// Start-up speed probe of src/outputs.c: outputs_init against buses that fail above a given
+// rate, now and then at 1 MHz, or always. It must settle on the fastest rate that passes
+// OLED_PROBE_TRIES probes in a row, fall back to 400 kHz when none does, and count every
+// failed probe.
+#include "check.h"
+#include "sim.h"
+#include "outputs.h"
+
+typedef struct {
+    const char *name;
+    uint max_baud, flaky_baud;
+    sim_fault_t fault;
+    uint32_t baud, errors;
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    {"clean bus", 0, 0, SIM_BUS_OK, 1000000, 0},
+    {"fails above 800 kHz", 800000, 0, SIM_BUS_OK, 800000, 1},
+    {"flaky at 1 MHz", 0, 800000, SIM_BUS_OK, 800000, 1},
+    {"fails above 400 kHz", 400000, 0, SIM_BUS_OK, 400000, 2},
+    {"dead bus", 0, 0, SIM_BUS_NACK, 400000, 4}, //the setup, then one probe per rate
+};
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++){
+        const scenario_t *s = &scenarios[i];
+        sim_i2c_max_baud = s->max_baud;
+        sim_i2c_flaky_baud = s->flaky_baud;
+        sim_i2c_set_fault(i2c0, s->fault);
+        sim_panel_reset(panel);
+        outputs_init();
+        printf("%-20s %7u Hz, %u errors\n", s->name, outputs_oled_baud(), outputs_oled_errors());
+        CHECK_EQ(outputs_oled_baud(), s->baud);
+        CHECK_EQ(outputs_oled_errors(), s->errors);
+        CHECK_EQ(i2c0->baudrate, s->baud);
+        if(s->fault == SIM_BUS_OK){
+            CHECK(panel->display_on);
+        }
+    }
+    return check_result();
+}
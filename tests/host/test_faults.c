@@ -0,0 +1,174 @@
+// Bus faults: NACKs, a stuck bus, a pulled module and a slave holding SDA, first against the
+// driver (bounded transfers, errors counted, writes dropped while offline, reinit restoring
+// the registers and the 9-clock bus clear), then against src/outputs.c in a 1 kHz loop like
+// the FSM's: a dead display must not slow the loop down, retries back off, and the frame
+// comes back whole, also after a brown-out that only the periodic presence check sees.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "outputs.h"
+
+#define OLED_CONTRAST 0x80 //as in src/outputs.c
+#define OLED_CHECK_MS 500
+
+#define SDA1_PIN 6 //i2c1
+#define SCL1_PIN 7
+
+static sh1106_t oled;
+
+static void scene(int k) {
+    SH1106_clear(&oled);
+    SH1106_fillRect(&oled, 10 * k, 8, 30, 20, 1);
+    SH1106_drawLine(&oled, 0, 63, 127, 0, 1);
+    SH1106_present(&oled);
+}
+
+static void driver_faults(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&oled, i2c1, 0x3C, 128, 64);
+    scene(0);
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+
+    // NACK: the first failed write takes the panel offline, the rest are dropped
+    sim_i2c_set_fault(i2c1, SIM_BUS_NACK);
+    uint64_t t0 = sim_now_us;
+    SH1106_setContrast(&oled, 0x10);
+    CHECK(!oled.online);
+    CHECK_EQ(oled.bus_errors, 1);
+    uint32_t txns = sim_i2c_transactions;
+    scene(1);
+    SH1106_draw(&oled);
+    SH1106_setInverse(&oled, true);
+    CHECK_EQ(sim_i2c_transactions, txns);
+    CHECK(sim_now_us - t0 < 1000);
+    CHECK(!SH1106_probe(&oled));
+
+    // Module pulled and plugged back in: reinit fails without it, then restores it whole
+    sim_i2c_set_fault(i2c1, SIM_BUS_OK);
+    sim_i2c_detach(i2c1, 0x3C);
+    CHECK(!SH1106_reinit(&oled));
+    panel = sim_i2c_attach(i2c1, 0x3C);
+    CHECK(SH1106_reinit(&oled));
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+    CHECK_EQ(panel->contrast, 0x10);
+    CHECK(panel->inverse);
+    CHECK(panel->display_on);
+
+    // Scrolled when the bus fails, and the scroll reset is dropped while offline: the panel
+    // keeps its registers, so only reinit replaying the stored line puts it back
+    SH1106_setStartLine(&oled, 20);
+    SH1106_setDisplayOffset(&oled, 4);
+    sim_i2c_set_fault(i2c1, SIM_BUS_NACK);
+    SH1106_setStartLine(&oled, 0);
+    SH1106_setDisplayOffset(&oled, 0);
+    CHECK(!oled.online);
+    CHECK_EQ(panel->start_line, 20);
+    sim_i2c_set_fault(i2c1, SIM_BUS_OK);
+    CHECK(SH1106_reinit(&oled));
+    CHECK_EQ(panel->start_line, 0);
+    CHECK_EQ(panel->offset, 0);
+
+    // Stuck bus: each attempt costs one timeout, not one per transfer of the frame
+    sim_i2c_set_fault(i2c1, SIM_BUS_STUCK);
+    scene(2);
+    t0 = sim_now_us;
+    SH1106_draw(&oled);
+    CHECK(!oled.online);
+    CHECK(sim_now_us - t0 <= SH1106_TIMEOUT_BASE_US + (SH1106_ROW_HEADER + 128) * SH1106_TIMEOUT_BYTE_US);
+    t0 = sim_now_us;
+    CHECK(!SH1106_reinit(&oled));
+    CHECK(sim_now_us - t0 < 5000);
+
+    // A slave starts holding SDA mid-frame: the DMA frame times out, reinit cannot get
+    // through, and only a bus clear gets the panel back
+    sim_i2c_set_fault(i2c1, SIM_BUS_OK);
+    CHECK(SH1106_reinit(&oled));
+    uint32_t dropped = oled.async_errors;
+    scene(3);
+    CHECK(SH1106_draw_async(&oled, NULL, NULL));
+    SH1106_poll(&oled);
+    sim_i2c_set_fault(i2c1, SIM_BUS_HELD);
+    while(SH1106_busy(&oled)){
+    }
+    CHECK_EQ(oled.async_errors, dropped + 1);
+    CHECK(!oled.online);
+    CHECK(!SH1106_reinit(&oled));
+    CHECK(!gpio_get(SDA1_PIN));
+    SH1106_busRecover(SDA1_PIN, SCL1_PIN);
+    CHECK(gpio_get(SDA1_PIN));
+    i2c_init(i2c1, 400000);
+    CHECK(SH1106_reinit(&oled));
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+}
+
+static timer fsm_timer = {100};
+static uint64_t worst_us;
+
+// The FSM's loop at 1 kHz with the display calls it makes in HEATING
+static void loop_for(uint32_t ms) {
+    for(uint32_t i = 0; i < ms; i++){
+        uint64_t t0 = sim_now_us;
+        outputs_update(fsm_timer);
+        outputs_service();
+        outputs_idle(false, false);
+        uint64_t spent = sim_now_us - t0;
+        worst_us = spent > worst_us ? spent : worst_us;
+        if(spent < 1000){
+            sim_advance_us(1000 - spent);
+        }
+    }
+}
+
+static void outputs_faults(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    outputs_init();
+    loop_for(2000);
+    uint8_t shown[8][132];
+    memcpy(shown, panel->ram, sizeof(shown));
+    uint64_t healthy_worst = worst_us;
+
+    // Dead bus for 20 s, and the panel browns out meanwhile
+    sim_i2c_set_fault(i2c0, SIM_BUS_STUCK);
+    sim_panel_reset(panel);
+    worst_us = 0;
+    uint32_t errors = outputs_oled_errors();
+    loop_for(20000);
+    uint32_t attempts = outputs_oled_errors() - errors;
+    printf("loop step: %llu us healthy, %llu us worst with the bus dead; %u failed attempts in 20 s\n",
+           (unsigned long long)healthy_worst, (unsigned long long)worst_us, attempts);
+    CHECK(worst_us < 10000);
+    CHECK(attempts >= 5 && attempts <= 15); //50 ms doubling to 5 s, not every loop
+    CHECK_EQ(outputs_oled_recoveries(), 0);
+
+    sim_i2c_set_fault(i2c0, SIM_BUS_OK);
+    loop_for(6000); //at most one 5 s wait
+    CHECK_EQ(outputs_oled_recoveries(), 1);
+    CHECK(memcmp(shown, panel->ram, sizeof(shown)) == 0);
+
+    // Brown-out with the bus healthy: nothing fails, only the presence check (status byte
+    // says off, remap lost) notices, replays the setup and resends the frame
+    sim_panel_reset(panel);
+    uint32_t ms = 0;
+    while(outputs_oled_recoveries() == 1 && ms <= OLED_CHECK_MS){
+        loop_for(1);
+        ms++;
+    }
+    printf("brown-out on a healthy bus noticed after %u ms\n", ms);
+    CHECK_EQ(outputs_oled_recoveries(), 2);
+    CHECK(ms <= OLED_CHECK_MS);
+    loop_for(50); //the frame goes out by DMA
+    CHECK(memcmp(shown, panel->ram, sizeof(shown)) == 0);
+    CHECK(panel->display_on && panel->seg_remap && panel->scan_flip);
+    CHECK_EQ(panel->contrast, OLED_CONTRAST);
+}
+
+int main(void) {
+    driver_faults();
+    outputs_faults();
+    return check_result();
+}
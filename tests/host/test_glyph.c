@@ -0,0 +1,71 @@
+// SH1106_drawChar's page blit against the per-pixel reference (ref_glyph.h): every printable
+// character, both colours, at page-aligned and unaligned y, clipped at the right and bottom
+// edges, over a noisy background. The two back buffers must match bit for bit.
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "ref_glyph.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+static sh1106_t blitted, reference;
+
+static void noise(void) {
+    for(uint8_t page = 0; page < 8; page++){
+        for(uint8_t x = 0; x < 128; x++){
+            uint8_t b = rand();
+            blitted.back[page][SH1106_ROW_HEADER + x] = b;
+            reference.back[page][SH1106_ROW_HEADER + x] = b;
+        }
+    }
+}
+
+static bool same(void) {
+    for(uint8_t page = 0; page < 8; page++){
+        if(memcmp(&blitted.back[page][SH1106_ROW_HEADER], &reference.back[page][SH1106_ROW_HEADER], 128) != 0){
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c0, 400000);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&blitted, i2c0, 0x3C, 128, 64);
+    SH1106_init(&reference, i2c1, 0x3C, 128, 64);
+    CHECK_EQ(font_inconsolata.width, REF_WIDTH + 1);
+    CHECK_EQ(font_inconsolata.height, REF_HEIGHT);
+
+    static const uint8_t xs[] = {0, 1, 60, 119, 120, 125};
+    static const uint8_t ys[] = {0, 3, 8, 21, 47, 48, 53};
+    srand(9);
+    int cases = 0, mismatches = 0;
+    for(int c = ' ' - 1; c <= '~' + 1; c++){ //one past each end: the fallback glyph
+        for(uint8_t color = 0; color < 2; color++){
+            for(size_t i = 0; i < sizeof(xs); i++){
+                for(size_t j = 0; j < sizeof(ys); j++){
+                    noise();
+                    SH1106_drawChar(&blitted, c, xs[i], ys[j], color, &font_inconsolata);
+                    ref_drawChar(&reference, c, xs[i], ys[j], color);
+                    if(!same()){
+                        fprintf(stderr, "'%c' color %u at (%u, %u) differs\n", c, color, xs[i], ys[j]);
+                        mismatches++;
+                    }
+                    cases++;
+                }
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    noise();
+    SH1106_drawString(&blitted, "12:34", 10, 20, 1, &font_inconsolata);
+    ref_drawString(&reference, "12:34", 10, 20, 1);
+    CHECK(same());
+    printf("%d glyph placements pixel-exact\n", cases);
+    return check_result();
+}
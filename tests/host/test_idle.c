@@ -0,0 +1,74 @@
+// Idle policy of src/outputs.c on the virtual clock, in a 1 kHz loop like the FSM's: in
+// STATE_OFF without input the contrast drops at OLED_DIM_MS, pump and display go off at
+// OLED_SLEEP_MS, and the bus is silent from then on; the first input wakes the panel in the
+// same loop and the frame it showed comes back.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "outputs.h"
+
+// As in src/outputs.c
+#define OLED_CONTRAST     0x80
+#define OLED_DIM_CONTRAST 0x08
+#define OLED_DIM_MS       15000
+#define OLED_SLEEP_MS     60000
+
+static sim_panel_t *panel;
+
+static void loop_once(bool en_off, bool actividad) {
+    outputs_idle(en_off, actividad);
+    outputs_service();
+    sim_advance_us(1000);
+}
+
+int main(void) {
+    panel = sim_i2c_attach(i2c0, 0x3C);
+    outputs_init();
+    timer t = {125};
+    for(int ms = 0; ms < 1000; ms++){
+        outputs_update(t);
+        loop_once(false, false);
+    }
+    uint8_t shown[8][132];
+    memcpy(shown, panel->ram, sizeof(shown));
+    CHECK_EQ(panel->contrast, OLED_CONTRAST);
+
+    // STATE_OFF from here on, no input: note when each change reaches the panel, in ms of
+    // virtual time since the last loop outside OFF
+    uint64_t t0 = sim_now_us - 1000;
+    int64_t dim_at = -1, sleep_at = -1;
+    while(sim_now_us - t0 < (OLED_SLEEP_MS + 1000) * 1000ull){
+        loop_once(true, false);
+        int64_t ms = (int64_t)(sim_now_us - t0) / 1000;
+        if(dim_at < 0 && panel->contrast == OLED_DIM_CONTRAST){
+            dim_at = ms;
+        }
+        if(sleep_at < 0 && !panel->display_on){
+            sleep_at = ms;
+            CHECK(!panel->charge_pump);
+        }
+    }
+    printf("dimmed after %lld ms, asleep after %lld ms\n", (long long)dim_at, (long long)sleep_at);
+    CHECK(dim_at >= OLED_DIM_MS && dim_at <= OLED_DIM_MS + 2);
+    CHECK(sleep_at >= OLED_SLEEP_MS && sleep_at <= OLED_SLEEP_MS + 2);
+
+    // Asleep: nothing on the bus, presence checks included
+    uint32_t txns = sim_i2c_transactions;
+    for(int ms = 0; ms < 30000; ms++){
+        loop_once(true, false);
+    }
+    CHECK_EQ(sim_i2c_transactions, txns);
+
+    // First input: awake by the end of that loop, then the frame goes out again
+    loop_once(true, true);
+    CHECK(panel->display_on);
+    CHECK(panel->charge_pump);
+    CHECK_EQ(panel->contrast, OLED_CONTRAST);
+    for(int ms = 0; ms < 100; ms++){
+        loop_once(true, false);
+    }
+    CHECK(memcmp(shown, panel->ram, sizeof(shown)) == 0);
+    CHECK_EQ(outputs_oled_errors(), 0);
+    return check_result();
+}
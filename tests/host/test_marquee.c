@@ -0,0 +1,64 @@
+// The DONE screen of src/outputs.c in a 1 kHz loop like the FSM's: once the alert has
+// flashed, each MARQUEE_STEP_MS step of the scrolling message is one 2-byte transaction
+// (control byte + start line) and the frame is never resent; the only other traffic is
+// the periodic presence check. Leaving DONE puts line 0 back.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "outputs.h"
+
+#define MARQUEE_STEP_MS 40 // as in src/outputs.c
+#define STEPS 100
+
+static void loop_for(uint32_t ms) {
+    for(uint32_t i = 0; i < ms; i++){
+        outputs_service();
+        outputs_idle(false, false);
+        sim_advance_us(1000);
+    }
+}
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    outputs_init();
+    action_show_done();
+    loop_for(3000); //the frame with the message and the 2 s alert
+    CHECK(!panel->inverse);
+
+    sim_panel_clear_log(panel);
+    uint32_t txns = sim_i2c_transactions;
+    uint64_t busy = sim_i2c_busy_us;
+    uint8_t line = panel->start_line;
+    uint32_t steps = 0;
+    for(uint32_t ms = 0; ms < STEPS * MARQUEE_STEP_MS; ms++){
+        loop_for(1);
+        if(panel->start_line != line){
+            CHECK_EQ(panel->start_line, (line + 1) % 64);
+            line = panel->start_line;
+            steps++;
+        }
+    }
+    // The presence check (OLED_CHECK_MS) shares the bus: a NOP write and a status read
+    uint32_t probes = 0;
+    for(uint32_t i = 0; i < panel->log_len; i++){
+        probes += panel->log[i] == SET_NOP;
+        CHECK(panel->log[i] == SET_NOP || (panel->log[i] & 0xC0) == SET_START_LINE);
+    }
+    uint32_t txns_step = sim_i2c_transactions - txns - 2 * probes;
+    printf("marquee: %u steps, %u transactions besides %u presence checks, %u data bytes\n", steps, txns_step,
+           probes, panel->data_bytes);
+    CHECK(steps >= STEPS - 1 && steps <= STEPS);
+    CHECK_EQ(txns_step, steps);
+    CHECK_EQ(panel->cmd_bytes - probes, steps);
+    CHECK_EQ(panel->data_bytes, 0);
+    //each step: address byte, then control byte and command, 9 bits a byte at the probed speed
+    uint32_t baud = outputs_oled_baud();
+    uint64_t step_us = (3 * 9 * 1000000ull + baud - 1) / baud;
+    uint64_t probe_us = step_us + (2 * 9 * 1000000ull + baud - 1) / baud;
+    CHECK_EQ(sim_i2c_busy_us - busy, steps * step_us + probes * probe_us);
+
+    action_show_zero();
+    CHECK_EQ(panel->start_line, 0);
+    return check_result();
+}
@@ -0,0 +1,73 @@
+// Several panels: one per I2C block and two on the same bus at 0x3C / 0x3D, of different
+// sizes. Each instance draws into its own buffers and each panel ends up with only its own
+// frame, through blocking draws and through SH1106_draw_all.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+#define PANELS 3
+
+static sh1106_t oled[PANELS];
+static sim_panel_t *panel[PANELS];
+
+static void scene(int i, int k) {
+    SH1106_clear(&oled[i]);
+    char text[] = "P0:0";
+    text[1] = '0' + i;
+    text[3] = '0' + k;
+    SH1106_drawString(&oled[i], text, 8 * i, 0, 1, &font_inconsolata);
+    SH1106_drawLine(&oled[i], 0, oled[i].height - 1, 20 * (i + 1), 16, 1);
+    SH1106_present(&oled[i]);
+}
+
+static void check_isolated(void) {
+    for(int i = 0; i < PANELS; i++){
+        CHECK(sim_panel_shows(panel[i], &oled[i]));
+        for(int j = 0; j < PANELS; j++){
+            if(j != i && oled[j].width == oled[i].width){
+                CHECK(!sim_panel_shows(panel[j], &oled[i]));
+            }
+        }
+    }
+}
+
+int main(void) {
+    i2c_init(i2c0, 400000);
+    i2c_init(i2c1, 400000);
+    panel[0] = sim_i2c_attach(i2c0, 0x3C);
+    panel[1] = sim_i2c_attach(i2c1, 0x3C);
+    panel[2] = sim_i2c_attach(i2c1, 0x3D);
+    SH1106_init(&oled[0], i2c0, 0x3C, 128, 64);
+    SH1106_init(&oled[1], i2c1, 0x3C, 128, 64);
+    SH1106_init(&oled[2], i2c1, 0x3D, 128, 32);
+    CHECK_EQ(oled[2].pages, 4);
+
+    // Drawing into one instance leaves the others' buffers alone
+    uint8_t before[SH1106_MAX_PAGES][SH1106_ROW_BYTES];
+    memcpy(before, oled[1].back, sizeof(before));
+    SH1106_fillRect(&oled[0], 0, 0, 128, 64, 1);
+    CHECK(memcmp(before, oled[1].back, sizeof(before)) == 0);
+    CHECK_EQ(oled[1].dirty.pages, 0);
+
+    for(int i = 0; i < PANELS; i++){
+        scene(i, 0);
+        SH1106_draw(&oled[i]);
+    }
+    check_isolated();
+
+    sh1106_t *const all[PANELS] = {&oled[0], &oled[1], &oled[2]};
+    for(int k = 1; k < 5; k++){
+        for(int i = 0; i < PANELS; i++){
+            scene(i, k);
+        }
+        SH1106_draw_all(all, PANELS);
+        check_isolated();
+    }
+    for(int i = 0; i < PANELS; i++){
+        CHECK(oled[i].online);
+        CHECK_EQ(oled[i].async_errors, 0);
+    }
+    return check_result();
+}
@@ -0,0 +1,128 @@
+// PIO transport: the descriptor queue on its own (random frames against its rules), then
+// whole frames through the chained-DMA model, including a present while one is in flight.
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "lib/sh1106_pio.h"
+#include "fonts/font_digits_large.h"
+#include "fonts/font_inconsolata.h"
+
+#define CS_PIN 17
+#define DC_PIN 20
+
+static sh1106_t oled;
+static sh1106_pio_queue_t queue;
+static uint8_t rows[8][132];
+
+// Random runs per page, in page and column order as the flush queues them. Every queued byte
+// must be covered, in at most SH1106_PIO_RUNS runs, each with a well-formed header pointing
+// at its own page row, and the returned byte counts must add up.
+static void queue_model(void) {
+    int reserve_hits = 0;
+    srand(1);
+    for(int frame = 0; frame < 20000; frame++){
+        static uint8_t want[8][132];
+        memset(want, 0, sizeof(want));
+        int pages = 1 + rand() % 8;
+        size_t bytes = 0;
+        sh1106_pio_queue_reset(&queue);
+        for(int page = 0; page < pages; page++){
+            for(int x = rand() % 20; x < 132 && rand() % 4; ){
+                int n = 1 + rand() % 12;
+                n = x + n > 132 ? 132 - x : n;
+                memset(&want[page][x], 1, n);
+                bytes += sh1106_pio_queue_run(&queue, page, x + 2, &rows[page][x], n, pages - 1 - page);
+                x += n + 1 + rand() % 10;
+            }
+        }
+        CHECK(queue.runs <= SH1106_PIO_RUNS);
+        reserve_hits += queue.runs >= SH1106_PIO_RUNS - pages + 1;
+        size_t total = 0;
+        int runs = 0;
+        for(const sh1106_pio_desc_t *d = queue.desc; d->read; d += 2, runs++){
+            const uint8_t *h = d[0].read;
+            CHECK_EQ(d[0].count, SH1106_PIO_HEADER);
+            CHECK(h[0] == 0 && h[1] == 2 && h[5] == 1 && h[6] == d[1].count - 1);
+            int page = h[2] & 0x0F, x = ((h[4] & 0x0F) << 4 | (h[3] & 0x0F)) - 2;
+            CHECK(d[1].read == &rows[page][x]);
+            for(uint32_t i = 0; i < d[1].count; i++){
+                want[page][x + i] = 0;
+            }
+            total += 3 + d[1].count;
+        }
+        CHECK_EQ(runs, queue.runs);
+        CHECK_EQ(total, bytes);
+        for(int page = 0; page < 8; page++){
+            for(int x = 0; x < 132; x++){
+                CHECK(!want[page][x]);
+            }
+        }
+    }
+    printf("queue model: 20000 frames, %d used the reserved slots\n", reserve_hits);
+}
+
+static uint8_t shown_at_done[8][132];
+static sim_panel_t *panel;
+
+static void on_done(sh1106_t *sh1106, void *user) {
+    memcpy(shown_at_done, panel->ram, sizeof(shown_at_done));
+}
+
+static void scene(int k) {
+    SH1106_clear(&oled);
+    for(int i = 0; i < 5; i++){
+        SH1106_drawChar(&oled, '0' + (k + i) % 10, 4 + 24 * i, 8, 1, &font_digits_large);
+    }
+    SH1106_drawLine(&oled, 0, 63 - k, 127, k, 1);
+}
+
+// Entering DONE presents twice in a row (zero, then the message): the second present must not
+// recycle the rows the first frame's DMA is still reading.
+static void present_in_flight(void) {
+    static uint8_t first[8][SH1106_ROW_BYTES];
+    sim_dma_burst = 4;
+    scene(1);
+    SH1106_present(&oled);
+    memcpy(first, oled.front, sizeof(first));
+    SH1106_draw_async(&oled, on_done, NULL);
+    CHECK(SH1106_busy(&oled));
+
+    scene(2);
+    SH1106_present(&oled);
+    for(int page = 0; page < 8; page++){
+        CHECK(memcmp(&shown_at_done[page][2], &first[page][SH1106_ROW_HEADER], 128) == 0);
+    }
+    SH1106_draw_async(&oled, NULL, NULL);
+    while(SH1106_busy(&oled)){
+    }
+    CHECK(sim_panel_shows(panel, &oled));
+    sim_dma_burst = 8;
+}
+
+int main(void) {
+    queue_model();
+
+    panel = sim_spi_attach(CS_PIN, DC_PIN);
+    SH1106_initPIO(&oled, pio0, 19, 18, CS_PIN, DC_PIN, 10000000, 128, 64);
+    SH1106_present(&oled);
+    SH1106_draw(&oled);
+    CHECK(sim_panel_shows(panel, &oled));
+
+    for(int k = 0; k < 10; k++){ //many short runs: some frames hit the queue reserve
+        scene(k);
+        for(int x = k; x < 128; x += 9){
+            SH1106_drawPixel(&oled, x, (x * 7 + k) % 64, 1);
+        }
+        SH1106_present(&oled);
+        CHECK(SH1106_draw_async(&oled, NULL, NULL));
+        while(SH1106_busy(&oled)){
+        }
+        CHECK(sim_panel_shows(panel, &oled));
+    }
+    CHECK_EQ(oled.async_errors, 0);
+
+    present_in_flight();
+    return check_result();
+}
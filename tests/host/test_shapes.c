@@ -0,0 +1,190 @@
+// Lines, circles, arcs and bitmaps: golden framebuffers for a few shapes drawn at the top
+// left corner, then clipping against random viewports, which must give exactly the
+// unclipped shape cut to the viewport, and nothing written past the panel edge.
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+
+#define GOLDEN_W 32
+#define GOLDEN_H 16
+
+static sh1106_t oled, full;
+
+// 12x8 door icon, row-major, MSB on the left
+static const uint8_t door[] = {0xFF, 0xF0, 0x80, 0x10, 0x80, 0x10, 0x80, 0x90, 0x80, 0x90, 0x80, 0x10, 0x80, 0x10, 0xFF, 0xF0};
+
+static const char *const golden_lines[GOLDEN_H] = {
+    "##......#.......................",
+    "..##...#........................",
+    "....##.#........................",
+    "......##........################",
+    "......#.##......................",
+    ".....#....##....................",
+    ".....#......##..................",
+    "....#.........##................",
+    "....#...........##..............",
+    "...#..............##............",
+    "...#................##..........",
+    "..#...................##........",
+    "..#.....................##......",
+    ".#........................##....",
+    ".#..........................##..",
+    "#.............................##",
+};
+
+static const char *const golden_circles[GOLDEN_H] = {
+    "................................",
+    "......#####.....................",
+    "....##.....##...................",
+    "...#.........#.........#####....",
+    "..#...........#.......#.....#...",
+    "..#...........#......#.......#..",
+    ".#.............#....#.........#.",
+    ".#.............#...#...........#",
+    ".#.............#...#...........#",
+    ".#.............#...#...........#",
+    ".#.............#................",
+    "..#...........#.................",
+    "..#...........#.................",
+    "...#.........#..................",
+    "....##.....##...................",
+    "......#####.....................",
+};
+
+static const char *const golden_bitmaps[GOLDEN_H] = {
+    "................................",
+    ".................##############.",
+    ".................##############.",
+    ".................#............#.",
+    ".................#.##########.#.",
+    ".############....#.##########.#.",
+    ".#..........#....#.#######.##.#.",
+    ".#..........#....#.#######.##.#.",
+    ".#.......#..#....#.##########.#.",
+    ".#.......#..#....#.##########.#.",
+    ".#..........#....#............#.",
+    ".#..........#....##############.",
+    ".############....##############.",
+    "................................",
+    "................................",
+    "................................",
+};
+
+static bool pixel(const sh1106_t *sh1106, int x, int y) {
+    return sh1106->back[y / 8][SH1106_ROW_HEADER + x] >> (y % 8) & 1;
+}
+
+// The whole panel: the golden in the corner, dark everywhere else
+static bool matches(const char *const golden[GOLDEN_H], const char *name) {
+    bool ok = true;
+    for(int y = 0; y < 64; y++){
+        for(int x = 0; x < 128; x++){
+            bool want = x < GOLDEN_W && y < GOLDEN_H && golden[y][x] == '#';
+            if(pixel(&oled, x, y) != want){
+                if(ok){
+                    fprintf(stderr, "%s: first difference at (%d, %d)\n", name, x, y);
+                }
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+static void goldens(void) {
+    SH1106_clear(&oled);
+    SH1106_drawLine(&oled, 0, 0, 31, 15, 1);
+    SH1106_drawLine(&oled, 0, 15, 8, 0, 1);
+    SH1106_drawLine(&oled, 31, 3, 16, 3, 1);
+    CHECK(matches(golden_lines, "lines"));
+
+    SH1106_clear(&oled);
+    SH1106_drawCircle(&oled, 8, 8, 7, 1);
+    SH1106_drawArc(&oled, 25, 9, 6, SH1106_ARC_UPPER, 1);
+    CHECK(matches(golden_circles, "circles"));
+
+    SH1106_clear(&oled);
+    SH1106_drawBitmap(&oled, 1, 5, 12, 8, door, 1);
+    SH1106_fillRect(&oled, 17, 1, 14, 12, 1);
+    SH1106_drawBitmap(&oled, 18, 3, 12, 8, door, 0);
+    CHECK(matches(golden_bitmaps, "bitmaps"));
+}
+
+static void shape(sh1106_t *sh1106, int kind, const int16_t *v, uint8_t color) {
+    switch(kind){
+    case 0: SH1106_drawLine(sh1106, v[0], v[1], v[2], v[3], color); break;
+    case 1: SH1106_drawCircle(sh1106, v[0], v[1], v[4] % 40, color); break;
+    case 2: SH1106_drawArc(sh1106, v[0], v[1], v[4] % 40, v[5], color); break;
+    default: SH1106_drawBitmap(sh1106, v[0], v[1], 12, 8, door, color); break;
+    }
+}
+
+// Random shapes reaching past random viewports: inside the viewport the clipped drawing is
+// the unclipped one, outside it the background is untouched.
+static void clipping(void) {
+    srand(15);
+    int failures = 0;
+    for(int n = 0; n < 4000; n++){
+        uint8_t vx = rand() % 128, vy = rand() % 64;
+        uint8_t vw = 1 + rand() % (128 - vx), vh = 1 + rand() % (64 - vy);
+        int16_t v[6];
+        for(int i = 0; i < 4; i++){
+            v[i] = (i % 2 ? -40 + rand() % 144 : -60 + rand() % 248);
+        }
+        v[4] = rand();
+        v[5] = rand();
+        uint8_t color = n % 2;
+        int kind = n % 4;
+        SH1106_fillRect(&oled, 0, 0, 128, 64, !color);
+        SH1106_fillRect(&full, 0, 0, 128, 64, !color);
+        SH1106_setViewport(&oled, vx, vy, vw, vh);
+        shape(&oled, kind, v, color);
+        shape(&full, kind, v, color);
+        SH1106_resetViewport(&oled);
+        bool ok = true;
+        for(int y = 0; y < 64; y++){
+            for(int x = 0; x < 128; x++){
+                bool inside = x >= vx && x < vx + vw && y >= vy && y < vy + vh;
+                ok &= pixel(&oled, x, y) == (inside ? pixel(&full, x, y) : !color);
+            }
+        }
+        if(!ok && failures++ < 5){
+            fprintf(stderr, "shape %d (%d, %d, %d, %d) in viewport %u,%u %ux%u clipped wrongly\n", kind, v[0], v[1],
+                    v[2], v[3], vx, vy, vw, vh);
+        }
+    }
+    CHECK_EQ(failures, 0);
+}
+
+// Nothing lands in the RAM columns past the panel width, whatever the coordinates
+static void edges(void) {
+    uint8_t past[SH1106_MAX_PAGES][SH1106_ROW_BYTES - SH1106_ROW_HEADER - 128];
+    for(int page = 0; page < 8; page++){
+        memcpy(past[page], &oled.back[page][SH1106_ROW_HEADER + 128], sizeof(past[page]));
+    }
+    SH1106_clear(&oled);
+    SH1106_drawPixel(&oled, 128, 10, 1);
+    SH1106_drawPixel(&oled, 200, 64, 1);
+    SH1106_drawLine(&oled, -32000, -32000, 32000, 32000, 1);
+    SH1106_drawLine(&oled, 127, -5, 140, 70, 1);
+    SH1106_drawCircle(&oled, 127, 32, 30, 1);
+    SH1106_drawBitmap(&oled, 124, 60, 12, 8, door, 1);
+    for(int page = 0; page < 8; page++){
+        CHECK(memcmp(past[page], &oled.back[page][SH1106_ROW_HEADER + 128], sizeof(past[page])) == 0);
+    }
+}
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c0, 400000);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+    SH1106_init(&full, i2c1, 0x3C, 128, 64);
+    goldens();
+    clipping();
+    edges();
+    return check_result();
+}
@@ -0,0 +1,61 @@
+// Span flush: a seconds tick of "MM:SS" in the 8x16 font sends only the columns of the digit
+// that changed, on its two pages, each page as one setup + data transaction.
+#include "check.h"
+#include "sim.h"
+#include "fonts/font_inconsolata.h"
+
+static sh1106_t oled;
+
+static const uint8_t *glyph(char c) {
+    return &font_inconsolata.glyphs[(c - font_inconsolata.first) * font_inconsolata.bytes_per_glyph];
+}
+
+static void show(char *text) {
+    SH1106_drawString(&oled, text, 0, 0, 1, &font_inconsolata);
+    SH1106_present(&oled);
+    SH1106_draw(&oled);
+}
+
+// Bytes a flush of the difference between two glyphs costs: per page, the setup header
+// (SH1106_ROW_HEADER) and the columns from the first to the last changed one.
+static uint32_t glyph_change_bytes(char from, char to) {
+    uint32_t bytes = 0;
+    uint8_t w = font_inconsolata.width;
+    for(uint8_t page = 0; page < font_inconsolata.height / 8; page++){
+        int first = -1, last = -1;
+        for(int x = 0; x < w; x++){
+            if(glyph(from)[page * w + x] != glyph(to)[page * w + x]){
+                first = first < 0 ? x : first;
+                last = x;
+            }
+        }
+        if(first >= 0){
+            bytes += SH1106_ROW_HEADER + (uint32_t)(last - first + 1);
+        }
+    }
+    return bytes;
+}
+
+int main(void) {
+    sim_panel_t *panel = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled, i2c0, 0x3C, 128, 64);
+
+    uint32_t sent = oled.bytes_sent, txns;
+    show("01:23"); //first frame: every page, whole width
+    CHECK(sim_panel_shows(panel, &oled));
+    CHECK_EQ(oled.bytes_sent - sent, 8 * (SH1106_ROW_HEADER + 128));
+
+    sent = oled.bytes_sent;
+    txns = oled.transactions;
+    show("01:24");
+    CHECK(sim_panel_shows(panel, &oled));
+    CHECK_EQ(oled.bytes_sent - sent, glyph_change_bytes('3', '4'));
+    CHECK_EQ(oled.transactions - txns, 2);
+    printf("01:23 -> 01:24: %u bytes in %u transactions\n", oled.bytes_sent - sent, oled.transactions - txns);
+
+    sent = oled.bytes_sent;
+    show("01:24"); //same text again: nothing to send
+    CHECK_EQ(oled.bytes_sent - sent, 0);
+    return check_result();
+}
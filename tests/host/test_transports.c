@@ -0,0 +1,103 @@
+// One script of frames and commands through every backend: the recording transport, I2C
+// blocking, I2C DMA, SPI and PIO. Each panel must receive exactly the command and data
+// stream the recording transport logged, and end up in the same state.
+#include <string.h>
+
+#include "check.h"
+#include "sim.h"
+#include "lib/sh1106_pio.h"
+#include "lib/sh1106_spi.h"
+#include "fonts/font_inconsolata.h"
+
+#define SPI_CS_PIN 13
+#define SPI_DC_PIN 14
+#define PIO_CS_PIN 17
+#define PIO_DC_PIN 20
+
+enum { BY_RECORD, BY_I2C, BY_I2C_DMA, BY_SPI, BY_PIO, BACKENDS };
+static const char *const names[BACKENDS] = {"record", "i2c", "i2c dma", "spi", "pio"};
+
+static sh1106_t oled[BACKENDS];
+static sim_panel_t *panel[BACKENDS];
+
+static void flush(sh1106_t *sh1106, bool async) {
+    SH1106_present(sh1106);
+    if(!async){
+        SH1106_draw(sh1106);
+        return;
+    }
+    SH1106_draw_async(sh1106, NULL, NULL);
+    while(SH1106_busy(sh1106)){
+    }
+}
+
+static void script(sh1106_t *sh1106, bool async) {
+    flush(sh1106, async);
+    for(int k = 0; k < 4; k++){
+        char text[] = "00:00";
+        text[4] += k;
+        SH1106_drawString(sh1106, text, 20, 8 * k, 1, &font_inconsolata);
+        SH1106_drawCircle(sh1106, 100, 32, 5 + 4 * k, 1);
+        SH1106_fillRect(sh1106, 3 * k, 60, 2, 4, k & 1);
+        flush(sh1106, async);
+    }
+    SH1106_setContrast(sh1106, 0x33);
+    SH1106_setInverse(sh1106, true);
+    SH1106_setStartLine(sh1106, 5);
+    SH1106_setDisplayOffset(sh1106, 3);
+    SH1106_displayOn(sh1106, false);
+    SH1106_clear(sh1106);
+    SH1106_drawLine(sh1106, 0, 0, 127, 63, 1);
+    flush(sh1106, async);
+    SH1106_displayOn(sh1106, true);
+}
+
+static bool same_state(const sim_panel_t *a, const sim_panel_t *b) {
+    return memcmp(a->ram, b->ram, sizeof(a->ram)) == 0 && a->start_line == b->start_line &&
+           a->offset == b->offset && a->contrast == b->contrast && a->display_on == b->display_on &&
+           a->inverse == b->inverse && a->charge_pump == b->charge_pump && a->seg_remap == b->seg_remap &&
+           a->scan_flip == b->scan_flip;
+}
+
+int main(void) {
+    panel[BY_RECORD] = &sim_recorded;
+    sim_panel_reset(&sim_recorded);
+    SH1106_initTransport(&oled[BY_RECORD], &sim_record_transport, 128, 64);
+
+    panel[BY_I2C] = sim_i2c_attach(i2c0, 0x3C);
+    i2c_init(i2c0, 400000);
+    SH1106_init(&oled[BY_I2C], i2c0, 0x3C, 128, 64);
+
+    panel[BY_I2C_DMA] = sim_i2c_attach(i2c1, 0x3C);
+    i2c_init(i2c1, 400000);
+    SH1106_init(&oled[BY_I2C_DMA], i2c1, 0x3C, 128, 64);
+
+    panel[BY_SPI] = sim_spi_attach(SPI_CS_PIN, SPI_DC_PIN);
+    spi_init(spi0, 10000000);
+    SH1106_initSPI(&oled[BY_SPI], spi0, SPI_CS_PIN, SPI_DC_PIN, 128, 64);
+
+    panel[BY_PIO] = sim_spi_attach(PIO_CS_PIN, PIO_DC_PIN);
+    SH1106_initPIO(&oled[BY_PIO], pio0, 19, 18, PIO_CS_PIN, PIO_DC_PIN, 10000000, 128, 64);
+
+    for(int b = 0; b < BACKENDS; b++){
+        script(&oled[b], b == BY_I2C_DMA || b == BY_PIO);
+    }
+    const sim_panel_t *ref = panel[BY_RECORD];
+    CHECK(ref->log_len < SIM_PANEL_LOG);
+    printf("reference stream: %u command and %u data bytes\n", ref->cmd_bytes, ref->data_bytes);
+    for(int b = 1; b < BACKENDS; b++){
+        const sim_panel_t *p = panel[b];
+        uint32_t at = 0;
+        while(at < ref->log_len && at < p->log_len && p->log[at] == ref->log[at]){
+            at++;
+        }
+        if(at != ref->log_len || p->log_len != ref->log_len){
+            fprintf(stderr, "%s: stream differs from the recording at entry %u of %u/%u\n", names[b], at,
+                    p->log_len, ref->log_len);
+            CHECK(false);
+        }
+        CHECK(same_state(p, ref));
+        CHECK(sim_panel_shows(p, &oled[b]));
+    }
+    return check_result();
+}
@@ -0,0 +1,47 @@
+// Widget redraw cost in src/outputs.c: a 10:00 -> 00:00 countdown in PAUSE, outputs_update
+// called every loop at 1 kHz (it refreshes at 20 Hz). Each second must be redrawn by one
+// update, the other refreshes of that second touch 0 pixels, and a tick never repaints
+// more than the digits that changed plus the bar. outputs_oled_pixels is the count.
+#include "check.h"
+#include "sim.h"
+#include "outputs.h"
+
+// As in src/outputs.c
+#define DIGIT_PX (24 * 48)
+#define BAR_PX   (120 * 5)
+
+#define TICKS 601
+
+int main(void) {
+    sim_i2c_attach(i2c0, 0x3C);
+    outputs_init();
+
+    uint32_t total = 0, worst = 0;
+    for(int s = TICKS - 1; s >= 0; s--){
+        timer t = {s};
+        uint32_t before = outputs_oled_pixels(), redraws = 0;
+        uint64_t t0 = sim_now_us;
+        while(sim_now_us - t0 < 1000000){
+            uint32_t px = outputs_oled_pixels();
+            outputs_update(t);
+            outputs_service();
+            outputs_idle(false, false);
+            sim_advance_us(1000);
+            redraws += outputs_oled_pixels() != px;
+        }
+        uint32_t tick = outputs_oled_pixels() - before;
+        CHECK_EQ(redraws, 1); //the rest of the second's refreshes drew nothing
+        if(s < TICKS - 1){ //the first tick draws the whole screen
+            total += tick;
+            worst = tick > worst ? tick : worst;
+        }
+    }
+    printf("%d ticks: %.0f px per tick on average, %u worst (full screen %d)\n", TICKS - 1,
+           (double)total / (TICKS - 1), worst, 128 * 64);
+    // At most four digits change at once (10:00 -> 09:59); the colon never does
+    CHECK(worst <= 4 * DIGIT_PX + BAR_PX);
+    // Mostly the last digit: well under two digit cells per tick
+    CHECK(total < (TICKS - 1) * (2 * DIGIT_PX + BAR_PX));
+    CHECK_EQ(outputs_oled_errors(), 0);
+    return check_result();
+}
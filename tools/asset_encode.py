@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+Encoder for compressed 1bpp assets (glyphs, icons) decoded by the SH1106 driver
+straight into the framebuffer.
+
+Data is page-major (for every page, one byte per column, LSB on top) and is
+compressed as a sequence of packets, each starting with a header byte:
+
+    00nnnnnn  literal: the next n+1 bytes are copied as they are
+    01nnnnnn  n+1 bytes of 0x00 (blank columns)
+    10nnnnnn  n+1 bytes of 0xFF (solid columns)
+    11nnnnnn  the next byte repeated n+2 times
+
+Used as a module by font_convert.py / segment_font.py, or standalone to turn a
+PBM image (P1 or P4) into an sh1106_image_t.
+"""
+import argparse
+import os
+import sys
+
+MAX_RUN = 64
+
+
+def encode(data):
+    out = []
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_RUN]
+            del literal[:MAX_RUN]
+            out.append(0x00 | (len(chunk) - 1))
+            out.extend(chunk)
+
+    i = 0
+    while i < len(data):
+        b = data[i]
+        run = 1
+        limit = MAX_RUN if b in (0x00, 0xFF) else MAX_RUN + 1
+        while i + run < len(data) and data[i + run] == b and run < limit:
+            run += 1
+        if b in (0x00, 0xFF) and (run >= 2 or not literal):
+            flush_literal()
+            out.append((0x40 if b == 0x00 else 0x80) | (run - 1))
+        elif run >= 3:
+            flush_literal()
+            out.extend([0xC0 | (run - 2), b])
+        else:
+            literal.extend(data[i:i + run])
+            i += run
+            continue
+        i += run
+    flush_literal()
+    return out
+
+
+def decode(packed, size):
+    out = []
+    i = 0
+    while len(out) < size:
+        h = packed[i]
+        i += 1
+        n = (h & 0x3F) + 1
+        kind = h >> 6
+        if kind == 0:
+            out.extend(packed[i:i + n])
+            i += n
+        elif kind == 1:
+            out.extend([0x00] * n)
+        elif kind == 2:
+            out.extend([0xFF] * n)
+        else:
+            out.extend([packed[i]] * (n + 1))
+            i += 1
+    return out
+
+
+def read_pbm(path):
+    raw = open(path, "rb").read()
+    tokens = []
+    pos = 0
+    while len(tokens) < 3:  # magic, width, height
+        while raw[pos:pos + 1].isspace():
+            pos += 1
+        if raw[pos:pos + 1] == b"#":
+            pos = raw.index(b"\n", pos)
+            continue
+        start = pos
+        while not raw[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(raw[start:pos].decode())
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if magic == "P4":
+        pos += 1
+        stride = (width + 7) // 8
+        bits = raw[pos:pos + stride * height]
+        px = [[(bits[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    elif magic == "P1":
+        digits = [int(ch) for ch in raw[pos:].decode() if ch in "01"]
+        px = [digits[y * width:(y + 1) * width] for y in range(height)]
+    else:
+        sys.exit("asset_encode: %s is not a P1/P4 PBM" % path)
+    return width, height, px
+
+
+def to_pages(px, width, height):
+    pages = (height + 7) // 8
+    out = [0] * (width * pages)
+    for y in range(height):
+        for x in range(width):
+            if px[y][x]:
+                out[(y // 8) * width + x] |= 1 << (y % 8)
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a PBM icon into a compressed sh1106_image_t")
+    ap.add_argument("--input", required=True, help="P1/P4 PBM image, 1 = lit pixel")
+    ap.add_argument("--name", required=True, help="C name of the generated image")
+    ap.add_argument("--raw", action="store_true", help="store uncompressed")
+    ap.add_argument("--out-dir", required=True)
+    args = ap.parse_args()
+
+    width, height, px = read_pbm(args.input)
+    data = to_pages(px, width, height)
+    payload = data if args.raw else encode(data)
+    assert args.raw or decode(payload, len(data)) == data
+    guard = "GENERATED_" + args.name.upper() + "_H"
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    with open(os.path.join(args.out_dir, args.name + ".h"), "w") as h:
+        h.write("// Generated by tools/asset_encode.py, do not edit.\n\n")
+        h.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        h.write('#include "lib/sh1106_i2c.h"\n\n')
+        h.write("extern const sh1106_image_t %s;\n\n" % args.name)
+        h.write("#endif //%s\n" % guard)
+    with open(os.path.join(args.out_dir, args.name + ".c"), "w") as c:
+        c.write("// Generated by tools/asset_encode.py, do not edit.\n\n")
+        c.write('#include "%s.h"\n\n' % args.name)
+        c.write("static const uint8_t %s_data[] = {\n" % args.name)
+        for k in range(0, len(payload), 16):
+            c.write("        " + ", ".join("0x%02X" % b for b in payload[k:k + 16]) + ",\n")
+        c.write("};\n\n")
+        c.write("const sh1106_image_t %s = {\n" % args.name)
+        c.write("    .width = %d,\n" % width)
+        c.write("    .height = %d,\n" % ((height + 7) // 8 * 8))
+        c.write("    .compressed = %s,\n" % ("false" if args.raw else "true"))
+        c.write("    .data = %s_data,\n" % args.name)
+        c.write("};\n")
+    print("asset_encode: %s %dx%d, %d bytes (raw %d bytes)" % (args.name, width, height, len(payload), len(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Converts a row-major bitmap font table (like lib/font_inconsolata.h) into the
+SH1106's native layout: page-major column bytes, LSB on top, already mirrored.
+
+The source table stores each glyph as `height` row bytes where bit j is the
+pixel in column (width - j) of the cell. The output stores, for every page of
+the glyph, `cell` column bytes (cell = width + gap), so SH1106_drawChar can
+copy them straight into the framebuffer.
+
+Emits <name>.c with the glyph table and an sh1106_font_t descriptor, and
+<name>.h declaring it.
+"""
+import argparse
+import os
+import re
+import sys
+
+from asset_encode import encode
+
+
+def parse_table(path):
+    text = open(path, encoding="utf-8").read()
+    body = text[text.index("{") + 1:text.rindex("}")]
+    body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)  # row drawings
+    body = re.sub(r"//[^\n]*", "", body)                # glyph headers
+    return [int(v, 16) for v in re.findall(r"0x([0-9A-Fa-f]{2})", body)]
+
+
+def convert_glyph(rows, width, height, gap):
+    cell = width + gap
+    pages = height // 8
+    out = [0] * (cell * pages)
+    for i, row in enumerate(rows):
+        for j in range(width):
+            if row & (1 << j):
+                col = gap + width - 1 - j
+                out[(i // 8) * cell + col] |= 1 << (i % 8)
+    return out
+
+
+def label(code):
+    if code is None:
+        return "fallback (blank)"
+    ch = chr(code)
+    return "'%s'" % ("\\\\" if ch == "\\" else ch)
+
+
+def emit(name, width, height, gap, glyphs, out_dir, sparse=False, rle=False):
+    """glyphs: list of (char code, page-major bytes). A dense font must hold
+    consecutive codes; a sparse one starts with a fallback glyph (code None)
+    and gets a char-to-glyph map over [first, last]. With rle every glyph is
+    compressed by asset_encode and located through an offsets table."""
+    cell = width + gap
+    bpg = cell * height // 8
+    codes = [code for code, _ in glyphs if code is not None]
+    first, last = min(codes), max(codes)
+    guard = "GENERATED_" + name.upper() + "_H"
+
+    with open(os.path.join(out_dir, name + ".h"), "w") as h:
+        h.write("// Generated by tools/font_convert.py, do not edit.\n\n")
+        h.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        h.write('#include "lib/sh1106_i2c.h"\n\n')
+        h.write("extern const sh1106_font_t %s;\n\n" % name)
+        h.write("#endif //%s\n" % guard)
+
+    with open(os.path.join(out_dir, name + ".c"), "w") as c:
+        c.write("// Generated by tools/font_convert.py, do not edit.\n\n")
+        c.write('#include "%s.h"\n\n' % name)
+        c.write("static const uint8_t %s_glyphs[] = {\n" % name)
+        offsets = []
+        payload = 0
+        for code, g in glyphs:
+            c.write("        // %s\n" % label(code))
+            if rle:
+                packed = encode(g)
+                offsets.append(payload)
+                payload += len(packed)
+                for k in range(0, len(packed), 16):
+                    c.write("        " + ", ".join("0x%02X" % b for b in packed[k:k + 16]) + ",\n")
+                continue
+            payload += bpg
+            for p in range(height // 8):
+                row = g[p * cell:(p + 1) * cell]
+                c.write("        " + ", ".join("0x%02X" % b for b in row) + ",\n")
+        c.write("};\n\n")
+        if rle:
+            c.write("static const uint16_t %s_offsets[] = {\n" % name)
+            for k in range(0, len(offsets), 8):
+                c.write("        " + ", ".join("%d" % o for o in offsets[k:k + 8]) + ",\n")
+            c.write("};\n\n")
+        if sparse:
+            index = {code: n for n, (code, _) in enumerate(glyphs) if code is not None}
+            c.write("// glyph of each char in [first, last], 0 (fallback) when not in the subset\n")
+            c.write("static const uint8_t %s_map[] = {\n" % name)
+            entries = [index.get(code, 0) for code in range(first, last + 1)]
+            for k in range(0, len(entries), 16):
+                c.write("        " + ", ".join("%d" % e for e in entries[k:k + 16]) + ",\n")
+            c.write("};\n\n")
+        c.write("const sh1106_font_t %s = {\n" % name)
+        c.write("    .width = %d,\n" % cell)
+        c.write("    .height = %d,\n" % height)
+        c.write("    .first = %d,\n" % first)
+        c.write("    .last = %d,\n" % last)
+        c.write("    .bytes_per_glyph = %d,\n" % bpg)
+        c.write("    .glyphs = %s_glyphs,\n" % name)
+        c.write("    .map = %s,\n" % ("%s_map" % name if sparse else "NULL"))
+        c.write("    .offsets = %s,\n" % ("%s_offsets" % name if rle else "NULL"))
+        c.write("};\n")
+
+    size = payload + (last - first + 1 if sparse else 0) + (2 * len(glyphs) if rle else 0)
+    return size
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--input", required=True, help="row-major font header")
+    ap.add_argument("--name", required=True, help="C name of the generated descriptor")
+    ap.add_argument("--width", type=int, default=8, help="glyph width in the source table")
+    ap.add_argument("--height", type=int, default=16, help="glyph height, multiple of 8")
+    ap.add_argument("--gap", type=int, default=1, help="blank columns in front of each glyph")
+    ap.add_argument("--first", type=int, default=32, help="code of the first glyph")
+    ap.add_argument("--chars", action="append", default=[],
+                    help="only keep these characters (repeatable, the union is kept)")
+    ap.add_argument("--rle", action="store_true", help="compress the glyphs (see asset_encode.py)")
+    ap.add_argument("--out-dir", required=True)
+    args = ap.parse_args()
+
+    if args.height % 8:
+        sys.exit("font_convert: height must be a multiple of 8")
+    data = parse_table(args.input)
+    if len(data) % args.height:
+        sys.exit("font_convert: %s does not hold whole %d-row glyphs" % (args.input, args.height))
+
+    glyphs = [(args.first + n, convert_glyph(data[i:i + args.height], args.width, args.height, args.gap))
+              for n, i in enumerate(range(0, len(data), args.height))]
+    full = len(glyphs) * (args.width + args.gap) * args.height // 8
+
+    sparse = bool(args.chars)
+    if sparse:
+        wanted = set(ord(ch) for chars in args.chars for ch in chars)
+        available = dict(glyphs)
+        missing = sorted(chr(code) for code in wanted if code not in available)
+        if missing:
+            sys.exit("font_convert: %s has no glyph for %s" % (args.input, "".join(missing)))
+        blank = [0] * len(glyphs[0][1])
+        glyphs = [(None, blank)] + [(code, available[code]) for code in sorted(wanted)]
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    size = emit(args.name, args.width, args.height, args.gap, glyphs, args.out_dir, sparse, args.rle)
+    print("font_convert: %s %d glyphs, %d bytes of .rodata (full table %d bytes)"
+          % (args.name, len(glyphs), size, full))
+
+
+if __name__ == "__main__":
+    main()
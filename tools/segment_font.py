@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Renders a 7-segment digit font ('0'..'9' and ':') at build time, directly in
+the SH1106 page-major layout, and emits it as an sh1106_font_t like
+font_convert.py does. Height must be a multiple of 8 so the digits can be
+drawn page-aligned, one whole byte per column and page.
+
+The bars are placed on page boundaries (see bar_rows) so that a segment
+turning on or off rewrites as few pages as possible: every tick of the
+countdown redraws a digit, and each page it touches is one more run on the bus.
+"""
+import argparse
+import os
+import sys
+
+from font_convert import emit
+
+#   aaa
+#  f   b
+#   ggg
+#  e   c
+#   ddd
+SEGMENTS = {
+    "0": "abcdef", "1": "bc", "2": "abdeg", "3": "abcdg", "4": "bcfg",
+    "5": "acdfg", "6": "acdefg", "7": "abc", "8": "abcdefg", "9": "abcdfg",
+}
+
+
+def bar_rows(height, thick):
+    """Top rows of bars a, g and d. a fills the bottom of the first page and d
+    the top of the last one, so those pages hold nothing else and the digit is
+    centred in the cell; g fills the bottom of the middle page, next to the
+    upper verticals only. For 48 rows and thickness 4: 4, 20 and 40."""
+    top = 8 - thick
+    bottom = height - 8
+    mid = (top + bottom) // 2 // 8 * 8 + 8 - thick
+    return top, mid, bottom
+
+
+def render(segments, width, height, thick, margin):
+    px = [[0] * width for _ in range(height)]
+
+    def hbar(top):
+        for k in range(thick):
+            bevel = 1 if k in (0, thick - 1) else 0
+            for x in range(margin + thick - 1 + bevel, width - margin - thick + 1 - bevel):
+                px[top + k][x] = 1
+
+    def vbar(left, top, bottom):
+        for k in range(thick):
+            bevel = 1 if k in (0, thick - 1) else 0
+            for y in range(top + bevel, bottom - bevel):
+                px[y][left + k] = 1
+
+    right = width - margin - thick
+    top, mid, bottom = bar_rows(height, thick)
+    if "a" in segments: hbar(top)
+    if "g" in segments: hbar(mid)
+    if "d" in segments: hbar(bottom)
+    if "f" in segments: vbar(margin, top + thick, mid)
+    if "b" in segments: vbar(right, top + thick, mid)
+    if "e" in segments: vbar(margin, mid + thick, bottom)
+    if "c" in segments: vbar(right, mid + thick, bottom)
+    return px
+
+
+def render_colon(width, height, thick):
+    px = [[0] * width for _ in range(height)]
+    x0 = (width - thick) // 2
+    top, mid, bottom = bar_rows(height, thick)
+    for cy in ((top + mid + thick) // 2, (mid + bottom + thick) // 2):
+        for y in range(cy - thick // 2, cy - thick // 2 + thick):
+            for x in range(x0, x0 + thick):
+                px[y][x] = 1
+    return px
+
+
+def to_pages(px, width, height):
+    out = [0] * (width * height // 8)
+    for y in range(height):
+        for x in range(width):
+            if px[y][x]:
+                out[(y // 8) * width + x] |= 1 << (y % 8)
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--name", required=True, help="C name of the generated descriptor")
+    ap.add_argument("--width", type=int, default=24)
+    ap.add_argument("--height", type=int, default=48)
+    ap.add_argument("--thick", type=int, default=4, help="segment thickness in pixels")
+    ap.add_argument("--margin", type=int, default=2, help="blank columns on each side")
+    ap.add_argument("--rle", action="store_true", help="compress the glyphs (see asset_encode.py)")
+    ap.add_argument("--out-dir", required=True)
+    args = ap.parse_args()
+
+    if args.height % 8:
+        sys.exit("segment_font: height must be a multiple of 8")
+    glyphs = [to_pages(render(SEGMENTS[d], args.width, args.height, args.thick, args.margin),
+                       args.width, args.height) for d in "0123456789"]
+    glyphs.append(to_pages(render_colon(args.width, args.height, args.thick), args.width, args.height))
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    size = emit(args.name, args.width, args.height, 0, list(zip(map(ord, "0123456789:"), glyphs)),
+                args.out_dir, rle=args.rle)
+    print("segment_font: %s %d glyphs, %d bytes of .rodata (raw %d bytes)"
+          % (args.name, len(glyphs), size, len(glyphs) * args.width * args.height // 8))
+
+
+if __name__ == "__main__":
+    main()